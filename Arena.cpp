@@ -0,0 +1,30 @@
+#include "Arena.h"
+
+void* Arena::Upstream::do_allocate(size_t size, size_t align) {
+    bytes += size;
+    return std::pmr::new_delete_resource()->allocate(size, align);
+}
+
+void Arena::Upstream::do_deallocate(void* p, size_t size, size_t align) {
+    std::pmr::new_delete_resource()->deallocate(p, size, align);
+}
+
+Arena::Arena(size_t slab_bytes) : capacity(slab_bytes), slab(new char[slab_bytes]) {
+    resource.reset(new std::pmr::monotonic_buffer_resource(slab.get(), capacity, &upstream));
+}
+
+void Arena::Reset() {
+    if (upstream.bytes == 0) {
+        // Frees nothing and points back at the start of the slab
+        resource->release();
+        return;
+    }
+    // The pass spilled: size the slab for what it needed, with headroom
+    size_t needed = capacity + upstream.bytes;
+    resource.reset();
+    capacity = needed + needed / 2;
+    slab.reset(new char[capacity]);
+    resource.reset(new std::pmr::monotonic_buffer_resource(slab.get(), capacity, &upstream));
+    upstream.bytes = 0;
+    growths++;
+}
@@ -0,0 +1,49 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <memory>
+#include <memory_resource>
+#include <cstddef>
+
+// Scratch memory for one collector pass. Transient containers (pid lists,
+// lookup sets, file buffers) take Resource() and are bump-allocated from a
+// slab that is kept across passes; Reset() rewinds it in O(1). A pass that
+// outgrows the slab spills to the heap, and the next Reset() grows the slab
+// to cover it, so a steady workload stops touching the heap after warm-up.
+// Nothing allocated here may outlive the pass: copy results into persistent
+// containers before Reset().
+class Arena {
+public:
+    static constexpr size_t kDefaultSlab = 256 * 1024;
+
+    explicit Arena(size_t slab_bytes = kDefaultSlab);
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    std::pmr::memory_resource* Resource() { return resource.get(); }
+    void Reset();
+
+    size_t Capacity() const { return capacity; }
+    size_t Spilled() const { return upstream.bytes; } // heap bytes since the last Reset()
+    size_t Growths() const { return growths; }
+
+private:
+    // Heap fallback that remembers how much the current pass needed
+    class Upstream : public std::pmr::memory_resource {
+    public:
+        size_t bytes = 0;
+
+    private:
+        void* do_allocate(size_t bytes, size_t align) override;
+        void do_deallocate(void* p, size_t bytes, size_t align) override;
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+    };
+
+    size_t capacity;
+    size_t growths = 0;
+    std::unique_ptr<char[]> slab;
+    Upstream upstream;
+    std::unique_ptr<std::pmr::monotonic_buffer_resource> resource;
+};
+
+#endif
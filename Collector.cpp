@@ -0,0 +1,103 @@
+#include "Collector.h"
+#include "Overhead.h"
+#include <algorithm>
+
+// Longest period the governor will stretch a collector to
+static const float kMaxPeriod = 600.0f;
+
+void CollectorRegistry::Register(std::unique_ptr<Collector> collector) {
+    pending.push_back(std::move(collector));
+}
+
+void CollectorRegistry::Start(float total_budget) {
+    std::vector<std::unique_ptr<Collector>> ready;
+    for (auto& c : pending) {
+        if (c->Init()) ready.push_back(std::move(c));
+    }
+    pending.clear();
+    if (ready.empty()) return;
+
+    float weights = 0.0f;
+    for (auto& c : ready) weights += c->BudgetWeight();
+
+    for (auto& c : ready) {
+        float share = total_budget * c->BudgetWeight() / weights;
+        Entry* e = new Entry();
+        e->collector = std::move(c);
+        e->configured.store(e->collector->DefaultPeriod());
+        e->budget = share;
+        e->cpu_per_run = e->collector->CostEstimate();
+        entries.emplace_back(e);
+
+        e->task = scheduler.Add(e->collector->Name(), e->collector->DefaultPeriod(), e->collector->Priority(), [this, e]() {
+            IoCounters io0 = thread_io.Read();
+            uint64_t allocs0 = Overhead::ThreadAllocations();
+            double cpu0 = Overhead::ThreadCpuSeconds();
+            Scheduler::Clock::time_point wall0 = Scheduler::Clock::now();
+            e->collector->Sample(*target, *scratch);
+            float cpu = (float)(Overhead::ThreadCpuSeconds() - cpu0);
+            float wall = std::chrono::duration<float>(Scheduler::Clock::now() - wall0).count();
+            float allocs = (float)(Overhead::ThreadAllocations() - allocs0);
+            IoCounters io1 = thread_io.Read();
+
+            e->cpu_per_run = e->cpu_per_run * 0.7f + cpu * 0.3f;
+            e->wall_per_run = e->wall_per_run * 0.7f + wall * 0.3f;
+            e->allocs_per_run = e->allocs_per_run * 0.7f + allocs * 0.3f;
+            e->syscalls_per_run = e->syscalls_per_run * 0.7f + (io1.syscalls - io0.syscalls) * 0.3f;
+            e->bytes_per_run = e->bytes_per_run * 0.7f + (io1.bytes - io0.bytes) * 0.3f;
+            target->versions[e->collector->Section()]++;
+            target->sampled_at[e->collector->Section()] = wall0;
+            Govern(*e);
+        });
+        Govern(*e); // a costly estimate stretches the period before the first run
+    }
+}
+
+void CollectorRegistry::Govern(Entry& e) {
+    // Shortest period at which this collector stays inside its CPU budget
+    float needed = e.budget > 0.0f ? e.cpu_per_run / e.budget : 0.0f;
+    float applied = std::min(std::max(e.configured.load(std::memory_order_relaxed), needed), kMaxPeriod);
+    scheduler.SetPeriod(e.task, applied);
+}
+
+size_t CollectorRegistry::RunDue(Snapshot& work, Arena& arena, Scheduler::Clock::time_point& next_deadline) {
+    target = &work;
+    scratch = &arena;
+    return scheduler.RunDue(Scheduler::Clock::now(), next_deadline);
+}
+
+void CollectorRegistry::Describe(std::vector<CadenceInfo>& out) const {
+    out.resize(entries.size());
+    for (size_t i = 0; i < entries.size(); ++i) {
+        const Entry& e = *entries[i];
+        const Scheduler::Task& task = scheduler.Get(e.task);
+        CadenceInfo& info = out[i];
+        info.name = task.name;
+        info.period = e.configured.load(std::memory_order_relaxed);
+        info.applied_period = task.period.load(std::memory_order_relaxed);
+        info.effective_hz = task.effective_hz;
+        info.cpu_ms = e.cpu_per_run * 1000.0f;
+        info.wall_ms = e.wall_per_run * 1000.0f;
+        info.allocs = e.allocs_per_run;
+        info.read_syscalls = e.syscalls_per_run;
+        info.read_kb = e.bytes_per_run / 1024.0f;
+        info.budget_percent = e.budget * 100.0f;
+        info.used_percent = info.applied_period > 0.0f ? 100.0f * e.cpu_per_run / info.applied_period : 0.0f;
+    }
+}
+
+void CollectorRegistry::CopyOut(const Snapshot& work, Snapshot& slot) const {
+    for (const auto& e : entries) {
+        SnapshotSection s = e->collector->Section();
+        if (slot.versions[s] == work.versions[s]) continue;
+        slot.versions[s] = work.versions[s];
+        slot.sampled_at[s] = work.sampled_at[s];
+        e->collector->CopyOut(work, slot);
+    }
+}
+
+void CollectorRegistry::SetPeriod(int id, float seconds) {
+    if (id < 0 || id >= (int)entries.size()) return;
+    // The collector thread picks this up on the next run, when Govern() re-applies the budget
+    entries[id]->configured.store(seconds, std::memory_order_relaxed);
+}
@@ -0,0 +1,81 @@
+#ifndef COLLECTOR_H
+#define COLLECTOR_H
+
+#include <vector>
+#include <memory>
+#include <atomic>
+#include "Snapshot.h"
+#include "Scheduler.h"
+#include "Overhead.h"
+#include "Arena.h"
+
+// A source of metrics. Sample() runs on the collector thread at the
+// collector's cadence and writes its section of the working snapshot.
+// Transient data goes in `scratch`, which is rewound after every publish.
+class Collector {
+public:
+    virtual ~Collector() {}
+
+    virtual const char* Name() const = 0;
+    virtual SnapshotSection Section() const = 0;
+    virtual float DefaultPeriod() const = 0;   // seconds
+    virtual int Priority() const = 0;          // lower runs first when several are due
+
+    // false disables the collector (missing kernel interface, no permission, ...)
+    virtual bool Init() { return true; }
+    virtual void Sample(Snapshot& snap, Arena& scratch) = 0;
+    // Copies what Sample() wrote from the working snapshot into a published one
+    virtual void CopyOut(const Snapshot& from, Snapshot& to) const = 0;
+    // Expected CPU seconds per Sample() before anything has been measured
+    virtual float CostEstimate() const { return 0.0005f; }
+    // Relative share of the registry's CPU budget
+    virtual float BudgetWeight() const { return 1.0f; }
+};
+
+// Owns the collectors, schedules them, measures what every run costs (CPU,
+// wall time, read syscalls and bytes, heap allocations) and
+// stretches the period of any collector that exceeds its CPU budget. The sum
+// of the per-collector budgets is a hard ceiling on the monitor's overhead.
+class CollectorRegistry {
+public:
+    // Fraction of one core the whole monitor may spend collecting
+    static constexpr float kDefaultTotalBudget = 0.10f;
+
+    void Register(std::unique_ptr<Collector> collector);
+    // Calls Init() on everything registered and schedules the ones that succeed.
+    // The total budget is split between them by BudgetWeight().
+    void Start(float total_budget = kDefaultTotalBudget);
+
+    // Runs everything due into `work`, with `scratch` for transient data; returns how many ran
+    size_t RunDue(Snapshot& work, Arena& scratch, Scheduler::Clock::time_point& next_deadline);
+    void Describe(std::vector<CadenceInfo>& out) const;
+    // Brings every section of `slot` whose version differs from `work` up to date
+    void CopyOut(const Snapshot& work, Snapshot& slot) const;
+
+    // Thread-safe; id indexes Snapshot::cadence
+    void SetPeriod(int id, float seconds);
+
+private:
+    struct Entry {
+        std::unique_ptr<Collector> collector;
+        int task = -1;
+        std::atomic<float> configured{1.0f}; // what the user asked for
+        float budget = 0.0f;                 // fraction of one core
+        float cpu_per_run = 0.0f;            // smoothed, seconds
+        float wall_per_run = 0.0f;
+        float allocs_per_run = 0.0f;         // smoothed like the above
+        float syscalls_per_run = 0.0f;
+        float bytes_per_run = 0.0f;
+    };
+
+    void Govern(Entry& e);
+
+    Scheduler scheduler;
+    std::vector<std::unique_ptr<Entry>> entries;  // only the ones that passed Init()
+    std::vector<std::unique_ptr<Collector>> pending;
+    Snapshot* target = nullptr;                   // working snapshot for the current RunDue()
+    Arena* scratch = nullptr;                     // and its scratch memory
+    IoMonitor thread_io{false};                   // the collector thread's own /proc/.../io
+};
+
+#endif
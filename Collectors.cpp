@@ -0,0 +1,184 @@
+#include "Collectors.h"
+#include <algorithm>
+#include <unistd.h>
+
+namespace {
+
+// Common plumbing for collectors that read through the shared System
+class SystemCollector : public Collector {
+public:
+    SystemCollector(System& system, const char* name, SnapshotSection section, float period, int priority)
+        : system(system), name(name), section(section), period(period), priority(priority) {}
+
+    const char* Name() const override { return name; }
+    SnapshotSection Section() const override { return section; }
+    float DefaultPeriod() const override { return period; }
+    int Priority() const override { return priority; }
+
+protected:
+    System& system;
+
+private:
+    const char* name;
+    SnapshotSection section;
+    float period;
+    int priority;
+};
+
+class CpuCollector : public SystemCollector {
+public:
+    CpuCollector(System& s) : SystemCollector(s, "CPU", SECTION_CPU, 0.1f, 0) {}
+    void Sample(Snapshot& snap, Arena&) override { snap.cpu = system.GetCpuUsage(); }
+    void CopyOut(const Snapshot& from, Snapshot& to) const override { to.cpu = from.cpu; }
+};
+
+class NetworkCollector : public SystemCollector {
+public:
+    NetworkCollector(System& s) : SystemCollector(s, "Network", SECTION_NETWORK, 0.1f, 0) {}
+    void Sample(Snapshot& snap, Arena& scratch) override { snap.net = system.GetNetworkStats(scratch.Resource()); }
+    void CopyOut(const Snapshot& from, Snapshot& to) const override { to.net = from.net; }
+};
+
+class MemoryCollector : public SystemCollector {
+public:
+    MemoryCollector(System& s) : SystemCollector(s, "Memory", SECTION_MEMORY, 0.5f, 1) {}
+    void Sample(Snapshot& snap, Arena&) override { snap.mem = system.GetMemoryUsage(); }
+    void CopyOut(const Snapshot& from, Snapshot& to) const override { to.mem = from.mem; }
+};
+
+class KernelCollector : public SystemCollector {
+public:
+    KernelCollector(System& s) : SystemCollector(s, "Kernel", SECTION_KERNEL, 1.0f, 1) {}
+    bool Init() override { return access("/proc/vmstat", R_OK) == 0; }
+    void Sample(Snapshot& snap, Arena&) override { snap.kernel = system.GetKernelActivity(); }
+    void CopyOut(const Snapshot& from, Snapshot& to) const override { to.kernel = from.kernel; }
+};
+
+class InterruptsCollector : public SystemCollector {
+public:
+    InterruptsCollector(System& s) : SystemCollector(s, "Interrupts", SECTION_INTERRUPTS, 1.0f, 2) {}
+    bool Init() override { return access("/proc/interrupts", R_OK) == 0; }
+    void Sample(Snapshot& snap, Arena&) override {
+        system.GetInterrupts(irq, softirq);
+        snap.irq = irq;
+        snap.softirq = softirq;
+    }
+    void CopyOut(const Snapshot& from, Snapshot& to) const override {
+        to.irq = from.irq;
+        to.softirq = from.softirq;
+    }
+    // The matrix scales with IRQs x CPUs
+    float CostEstimate() const override { return 0.00002f * sysconf(_SC_NPROCESSORS_CONF); }
+
+private:
+    IrqMatrix irq, softirq; // persistent so row labels are parsed once, then copied out
+};
+
+class ProcessCollector : public SystemCollector {
+public:
+    ProcessCollector(System& s) : SystemCollector(s, "Processes", SECTION_PROCESSES, 1.0f, 2) {}
+    void Sample(Snapshot& snap, Arena& scratch) override {
+        system.SweepProcesses(snap.procs, snap.sweep, scratch.Resource());
+        snap.procs.SortByCpu();
+    }
+    void CopyOut(const Snapshot& from, Snapshot& to) const override {
+        to.procs = from.procs;
+        to.sweep = from.sweep;
+    }
+    // Three /proc files per pid, roughly 20us each, capped by the sweep budget
+    float CostEstimate() const override { return 0.00006f * std::min(Parser::Pids().size(), ProcessSweep::kDefaultMaxPids); }
+    float BudgetWeight() const override { return 4.0f; }
+};
+
+class DescriptorCollector : public SystemCollector {
+public:
+    DescriptorCollector(System& s) : SystemCollector(s, "Descriptors", SECTION_FDS, 2.0f, 3) {}
+    void Sample(Snapshot& snap, Arena& scratch) override { system.GetFdUsage(snap.procs, snap.fds, scratch.Resource()); }
+    void CopyOut(const Snapshot& from, Snapshot& to) const override { to.fds = from.fds; }
+};
+
+class SocketsCollector : public SystemCollector {
+public:
+    SocketsCollector(System& s) : SystemCollector(s, "Sockets", SECTION_SOCKETS, 2.0f, 3) {}
+    void Sample(Snapshot& snap, Arena& scratch) override {
+        system.GetSockets(snap.procs, snap.sockets, scratch.Resource());
+        // Recount in place so pids that keep their sockets keep their map nodes
+        for (auto& kv : snap.conn_count) kv.second = 0;
+        for (const auto& sock : snap.sockets) {
+            if (sock.pid >= 0) snap.conn_count[sock.pid]++;
+        }
+        for (auto it = snap.conn_count.begin(); it != snap.conn_count.end();) {
+            if (it->second == 0) it = snap.conn_count.erase(it);
+            else ++it;
+        }
+    }
+    void CopyOut(const Snapshot& from, Snapshot& to) const override {
+        to.sockets = from.sockets;
+        to.conn_count = from.conn_count;
+    }
+    float BudgetWeight() const override { return 2.0f; }
+};
+
+class NumaNodesCollector : public SystemCollector {
+public:
+    NumaNodesCollector(System& s) : SystemCollector(s, "NUMA", SECTION_NUMA, 2.0f, 3) {}
+    bool Init() override { return access("/sys/devices/system/node", R_OK) == 0; }
+    void Sample(Snapshot& snap, Arena&) override {
+        snap.numa = system.GetNumaNodes();
+        snap.numa_proc = (snap.selected_pid >= 0) ? system.GetNumaProcess(snap.selected_pid) : NumaProcess();
+    }
+    void CopyOut(const Snapshot& from, Snapshot& to) const override {
+        to.numa = from.numa;
+        to.numa_proc = from.numa_proc;
+    }
+};
+
+class OverheadCollector : public SystemCollector {
+public:
+    OverheadCollector(System& s) : SystemCollector(s, "Self", SECTION_SELF, 1.0f, 5) {}
+    void Sample(Snapshot& snap, Arena&) override { snap.self = monitor.Collect(); }
+    void CopyOut(const Snapshot& from, Snapshot& to) const override { to.self = from.self; }
+    float BudgetWeight() const override { return 0.5f; }
+
+private:
+    OverheadMonitor monitor;
+};
+
+class ConnectivityCollector : public SystemCollector {
+public:
+    ConnectivityCollector(System& s) : SystemCollector(s, "Connectivity", SECTION_CONNECTIVITY, 5.0f, 4) {}
+    void Sample(Snapshot& snap, Arena&) override { snap.online = system.IsConnected(); }
+    void CopyOut(const Snapshot& from, Snapshot& to) const override { to.online = from.online; }
+};
+
+class DiskCollector : public SystemCollector {
+public:
+    DiskCollector(System& s) : SystemCollector(s, "Disks", SECTION_DISKS, 10.0f, 4) {}
+    void Sample(Snapshot& snap, Arena&) override { snap.disks = system.GetDisks(); }
+    void CopyOut(const Snapshot& from, Snapshot& to) const override { to.disks = from.disks; }
+};
+
+class BatteryCollector : public SystemCollector {
+public:
+    BatteryCollector(System& s) : SystemCollector(s, "Battery", SECTION_BATTERY, 30.0f, 5) {}
+    void Sample(Snapshot& snap, Arena&) override { snap.battery = system.GetBattery(); }
+    void CopyOut(const Snapshot& from, Snapshot& to) const override { to.battery = from.battery; }
+};
+
+} // namespace
+
+void RegisterBuiltinCollectors(CollectorRegistry& registry, System& system) {
+    registry.Register(std::unique_ptr<Collector>(new CpuCollector(system)));
+    registry.Register(std::unique_ptr<Collector>(new NetworkCollector(system)));
+    registry.Register(std::unique_ptr<Collector>(new MemoryCollector(system)));
+    registry.Register(std::unique_ptr<Collector>(new KernelCollector(system)));
+    registry.Register(std::unique_ptr<Collector>(new InterruptsCollector(system)));
+    registry.Register(std::unique_ptr<Collector>(new ProcessCollector(system)));
+    registry.Register(std::unique_ptr<Collector>(new DescriptorCollector(system)));
+    registry.Register(std::unique_ptr<Collector>(new SocketsCollector(system)));
+    registry.Register(std::unique_ptr<Collector>(new NumaNodesCollector(system)));
+    registry.Register(std::unique_ptr<Collector>(new ConnectivityCollector(system)));
+    registry.Register(std::unique_ptr<Collector>(new DiskCollector(system)));
+    registry.Register(std::unique_ptr<Collector>(new BatteryCollector(system)));
+    registry.Register(std::unique_ptr<Collector>(new OverheadCollector(system)));
+}
@@ -0,0 +1,11 @@
+#ifndef COLLECTORS_H
+#define COLLECTORS_H
+
+#include "Collector.h"
+#include "System.h"
+
+// Registers every built-in collector. They all share `system` (and so its
+// stateful readers), which is safe because the registry runs them on one thread.
+void RegisterBuiltinCollectors(CollectorRegistry& registry, System& system);
+
+#endif
@@ -0,0 +1,405 @@
+#include "Columnar.h"
+#include "Recording.h"
+#include "History.h"
+#include <memory>
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+#include <cstddef>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// --- FILE LAYOUT ---
+namespace {
+
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t columns;
+    uint64_t file_bytes;
+    uint32_t byte_order;
+    uint32_t reserved[9];
+};
+
+struct ColumnEntry {
+    char name[32];
+    uint32_t type;
+    uint32_t dict_count;
+    uint64_t rows;
+    uint64_t offset;
+    uint64_t dict_offset;
+};
+
+static_assert(sizeof(FileHeader) == 64 && sizeof(ColumnEntry) == 64, "layout is part of the format");
+
+const char kMagic[8] = {'N', 'M', 'C', 'O', 'L', '0', '0', '1'};
+const uint32_t kVersion = 1;
+const uint32_t kByteOrder = 0x01020304;
+const uint64_t kAlign = 64;
+
+size_t Width(uint32_t type) {
+    switch (type) {
+        case COLUMN_INT64: return 8;
+        case COLUMN_INT32:
+        case COLUMN_FLOAT32:
+        case COLUMN_DICT: return 4;
+        case COLUMN_UINT8: return 1;
+    }
+    return 0;
+}
+
+uint64_t Aligned(uint64_t at) { return (at + kAlign - 1) / kAlign * kAlign; }
+
+}
+
+// --- WRITER ---
+ColumnWriter::~ColumnWriter() {
+    for (Column& c : columns) {
+        if (c.spool) fclose(c.spool);
+    }
+}
+
+int ColumnWriter::Add(const std::string& name, ColumnType type) {
+    if (name.size() >= sizeof(ColumnEntry::name) || Width(type) == 0) return -1;
+    FILE* spool = tmpfile();
+    if (!spool) return -1;
+    columns.emplace_back();
+    columns.back().name = name;
+    columns.back().type = type;
+    columns.back().spool = spool;
+    return (int)columns.size() - 1;
+}
+
+void ColumnWriter::Put(int column, const void* value, size_t bytes) {
+    if (column < 0) return;
+    Column& c = columns[column];
+    fwrite(value, bytes, 1, c.spool);
+    c.rows++;
+}
+
+void ColumnWriter::String(int column, const char* text, size_t len) {
+    if (column < 0) return;
+    Column& c = columns[column];
+    auto it = c.codes.emplace(std::string(text, len), (uint32_t)c.strings.size()).first;
+    if (it->second == c.strings.size()) c.strings.push_back(it->first);
+    uint32_t code = it->second;
+    Put(column, &code, sizeof(code));
+}
+
+bool ColumnWriter::Finish(const std::string& path, std::string& error) {
+    // Layout first: header, entries, then each column's data and dictionary
+    std::vector<ColumnEntry> entries(columns.size());
+    uint64_t at = Aligned(sizeof(FileHeader) + entries.size() * sizeof(ColumnEntry));
+    for (size_t i = 0; i < columns.size(); ++i) {
+        const Column& c = columns[i];
+        ColumnEntry& e = entries[i];
+        memset(&e, 0, sizeof(e));
+        memcpy(e.name, c.name.data(), c.name.size());
+        e.type = c.type;
+        e.rows = c.rows;
+        e.offset = at;
+        at = Aligned(at + c.rows * Width(c.type));
+        if (c.type == COLUMN_DICT) {
+            e.dict_count = (uint32_t)c.strings.size();
+            e.dict_offset = at;
+            uint64_t blob = 0;
+            for (const std::string& s : c.strings) blob += s.size();
+            at = Aligned(at + c.strings.size() * sizeof(uint64_t) + blob);
+        }
+    }
+    FileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.columns = (uint32_t)columns.size();
+    header.file_bytes = at;
+    header.byte_order = kByteOrder;
+
+    // Written under a temporary name, so a reader never maps a half-written file
+    std::string temp = path + ".tmp";
+    FILE* out = fopen(temp.c_str(), "wb");
+    if (!out) {
+        error = "cannot create " + temp + ": " + strerror(errno);
+        return false;
+    }
+    std::vector<char> buffer(1u << 20);
+    uint64_t written = 0;
+    auto write = [&](const void* p, size_t n) {
+        fwrite(p, 1, n, out);
+        written += n;
+    };
+    auto pad = [&](uint64_t to) {
+        static const char zeros[kAlign] = {};
+        while (written < to) write(zeros, (size_t)std::min<uint64_t>(to - written, kAlign));
+    };
+    write(&header, sizeof(header));
+    if (!entries.empty()) write(entries.data(), entries.size() * sizeof(ColumnEntry));
+    for (size_t i = 0; i < columns.size(); ++i) {
+        Column& c = columns[i];
+        pad(entries[i].offset);
+        rewind(c.spool);
+        size_t n;
+        while ((n = fread(buffer.data(), 1, buffer.size(), c.spool)) > 0) write(buffer.data(), n);
+        if (c.type == COLUMN_DICT) {
+            pad(entries[i].dict_offset);
+            uint64_t end = 0;
+            for (const std::string& s : c.strings) {
+                end += s.size();
+                write(&end, sizeof(end));
+            }
+            for (const std::string& s : c.strings) write(s.data(), s.size());
+        }
+        if (ferror(c.spool)) {
+            error = "cannot read back the values of " + c.name;
+            break;
+        }
+    }
+    pad(header.file_bytes);
+    bool ok = error.empty() && written == header.file_bytes && fflush(out) == 0 && !ferror(out);
+    if (error.empty() && !ok) error = "cannot write " + temp + ": " + strerror(errno);
+    fclose(out);
+    if (ok && rename(temp.c_str(), path.c_str()) != 0) {
+        error = "cannot rename to " + path + ": " + strerror(errno);
+        ok = false;
+    }
+    if (!ok) unlink(temp.c_str());
+
+    for (Column& c : columns) fclose(c.spool);
+    columns.clear();
+    return ok;
+}
+
+// --- READER ---
+bool ColumnFile::Open(const std::string& path, std::string& error) {
+    Close();
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        error = "cannot open " + path + ": " + strerror(errno);
+        return false;
+    }
+    struct stat st;
+    void* p = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && (size_t)st.st_size >= sizeof(FileHeader))
+        p = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) {
+        error = path + ": not a column file";
+        return false;
+    }
+    map = (const uint8_t*)p;
+    size = (size_t)st.st_size;
+
+    const FileHeader& h = *(const FileHeader*)map;
+    if (memcmp(h.magic, kMagic, sizeof(kMagic)) != 0 || h.version != kVersion || h.byte_order != kByteOrder ||
+        h.file_bytes != size || sizeof(FileHeader) + (uint64_t)h.columns * sizeof(ColumnEntry) > size) {
+        error = path + ": not a column file, or from another version or byte order";
+        Close();
+        return false;
+    }
+    const ColumnEntry* entries = (const ColumnEntry*)(map + sizeof(FileHeader));
+    for (uint32_t i = 0; i < h.columns; ++i) {
+        const ColumnEntry& e = entries[i];
+        size_t width = Width(e.type);
+        bool valid = width > 0 && memchr(e.name, '\0', sizeof(e.name)) && e.offset % kAlign == 0 && e.offset <= size &&
+                     e.rows <= (size - e.offset) / width;
+        const uint64_t* dict_ends = nullptr;
+        if (valid && e.type == COLUMN_DICT) {
+            valid = e.dict_offset % 8 == 0 && e.dict_offset <= size && e.dict_count <= (size - e.dict_offset) / sizeof(uint64_t);
+            if (valid) {
+                dict_ends = (const uint64_t*)(map + e.dict_offset);
+                uint64_t blob = e.dict_offset + (uint64_t)e.dict_count * sizeof(uint64_t);
+                uint64_t prev = 0;
+                for (uint32_t k = 0; k < e.dict_count && valid; ++k) {
+                    valid = dict_ends[k] >= prev && dict_ends[k] <= size - blob;
+                    prev = dict_ends[k];
+                }
+            }
+        }
+        if (!valid) {
+            error = path + ": column " + std::to_string(i) + " is damaged";
+            Close();
+            return false;
+        }
+        columns.push_back({e.name, (ColumnType)e.type, e.rows, map + e.offset, e.dict_count});
+        ends.push_back(dict_ends);
+    }
+    return true;
+}
+
+void ColumnFile::Close() {
+    if (map) munmap((void*)map, size);
+    map = nullptr;
+    size = 0;
+    columns.clear();
+    ends.clear();
+}
+
+int ColumnFile::Find(const std::string& name) const {
+    for (size_t i = 0; i < columns.size(); ++i) {
+        if (columns[i].name == name) return (int)i;
+    }
+    return -1;
+}
+
+std::string ColumnFile::Text(int column, uint32_t code) const {
+    if (column < 0 || column >= (int)columns.size() || !ends[column] || code >= columns[column].dict_count) return std::string();
+    const uint64_t* e = ends[column];
+    const char* blob = (const char*)(e + columns[column].dict_count);
+    uint64_t begin = code == 0 ? 0 : e[code - 1];
+    return std::string(blob + begin, blob + e[code]);
+}
+
+// --- EXPORT ---
+namespace Columnar {
+
+static bool ExportRecording(const std::string& in, ColumnWriter& w, std::string& error, uint64_t& rows) {
+    SessionPlayer player;
+    if (!player.Open(in, error)) return false;
+
+    int sys_t = w.Add("system.t_ms", COLUMN_INT64);
+    int sys_cpu = w.Add("system.cpu", COLUMN_FLOAT32);
+    int sys_mem = w.Add("system.mem", COLUMN_FLOAT32);
+    int sys_rx = w.Add("system.net_rx_kbs", COLUMN_FLOAT32);
+    int sys_tx = w.Add("system.net_tx_kbs", COLUMN_FLOAT32);
+    int sys_running = w.Add("system.procs_running", COLUMN_INT32);
+    int sys_blocked = w.Add("system.procs_blocked", COLUMN_INT32);
+    int sys_ctxt = w.Add("system.ctxt", COLUMN_FLOAT32);
+    int sys_majflt = w.Add("system.pgmajfault", COLUMN_FLOAT32);
+    int sys_self = w.Add("system.self_cpu", COLUMN_FLOAT32);
+    int proc_t = w.Add("processes.t_ms", COLUMN_INT64);
+    int proc_pid = w.Add("processes.pid", COLUMN_INT32);
+    int proc_ppid = w.Add("processes.ppid", COLUMN_INT32);
+    int proc_start = w.Add("processes.starttime", COLUMN_INT64);
+    int proc_cpu = w.Add("processes.cpu", COLUMN_FLOAT32);
+    int proc_rss = w.Add("processes.rss_mb", COLUMN_FLOAT32);
+    int proc_state = w.Add("processes.state", COLUMN_UINT8);
+    int proc_command = w.Add("processes.command", COLUMN_DICT);
+    if (proc_command < 0) {
+        error = "cannot create spool files";
+        return false;
+    }
+
+    // One row per sample: a process row repeats across frames until it is read again
+    struct Last {
+        long long starttime;
+        int64_t t_ms;
+    };
+    std::unordered_map<int, Last> last;
+    std::unique_ptr<Snapshot> snap(new Snapshot());
+    uint64_t procs_version = 0;
+    player.Seek(player.StartMs(), *snap);
+    do {
+        int64_t now = player.PositionMs();
+        w.Int64(sys_t, now);
+        w.Float(sys_cpu, snap->cpu);
+        w.Float(sys_mem, snap->mem);
+        w.Float(sys_rx, snap->net.first);
+        w.Float(sys_tx, snap->net.second);
+        w.Int32(sys_running, (int32_t)snap->kernel.procs_running);
+        w.Int32(sys_blocked, (int32_t)snap->kernel.procs_blocked);
+        w.Float(sys_ctxt, snap->kernel.ctxt);
+        w.Float(sys_majflt, snap->kernel.pgmajfault);
+        w.Float(sys_self, snap->self.cpu_percent);
+        rows++;
+
+        if (snap->versions[SECTION_PROCESSES] == procs_version) continue;
+        procs_version = snap->versions[SECTION_PROCESSES];
+        const ProcessTable& t = snap->procs;
+        std::chrono::steady_clock::time_point applied = snap->sampled_at[SECTION_PROCESSES];
+        for (size_t i = 0; i < t.Size(); ++i) {
+            int64_t sampled = now - std::chrono::duration_cast<std::chrono::milliseconds>(applied - t.sampled_at[i]).count();
+            auto it = last.find(t.pid[i]);
+            if (it != last.end() && it->second.starttime == t.starttime[i] && it->second.t_ms >= sampled) continue;
+            last[t.pid[i]] = {t.starttime[i], sampled};
+            const char* command = t.Command(i);
+            w.Int64(proc_t, sampled);
+            w.Int32(proc_pid, t.pid[i]);
+            w.Int32(proc_ppid, t.ppid[i]);
+            w.Int64(proc_start, t.starttime[i]);
+            w.Float(proc_cpu, t.cpu[i]);
+            w.Float(proc_rss, t.rss_mb[i]);
+            w.Byte(proc_state, (uint8_t)t.state[i]);
+            w.String(proc_command, command, strlen(command));
+            rows++;
+        }
+    } while (player.Step(*snap));
+    return true;
+}
+
+static bool ExportHistory(const std::string& in, ColumnWriter& w, std::string& error, uint64_t& rows) {
+    std::unique_ptr<HistoryStore> store = HistoryStore::OpenReadOnly(in);
+    if (!store->Error().empty()) {
+        error = in + ": " + store->Error();
+        return false;
+    }
+    int raw_series = w.Add("history.series", COLUMN_DICT);
+    int raw_t = w.Add("history.t_ms", COLUMN_INT64);
+    int raw_value = w.Add("history.value", COLUMN_FLOAT32);
+    int roll_series = w.Add("rollup.series", COLUMN_DICT);
+    int roll_width = w.Add("rollup.width_ms", COLUMN_INT32);
+    int roll_t = w.Add("rollup.t_ms", COLUMN_INT64);
+    int roll_min = w.Add("rollup.min", COLUMN_FLOAT32);
+    int roll_max = w.Add("rollup.max", COLUMN_FLOAT32);
+    int roll_avg = w.Add("rollup.avg", COLUMN_FLOAT32);
+    int roll_count = w.Add("rollup.count", COLUMN_INT32);
+    if (roll_count < 0) {
+        error = "cannot create spool files";
+        return false;
+    }
+
+    std::vector<std::string> names = store->Names();
+    std::vector<HistorySample> samples;
+    std::vector<HistoryBucket> buckets;
+    for (int id = 0; id < (int)names.size(); ++id) {
+        const std::string& name = names[id];
+        store->Range(id, INT64_MIN, INT64_MAX, samples);
+        for (const HistorySample& s : samples) {
+            w.String(raw_series, name.data(), name.size());
+            w.Int64(raw_t, s.t_ms);
+            w.Float(raw_value, s.value);
+        }
+        rows += samples.size();
+        for (int k = 0; k < HistoryStore::kTiers; ++k) {
+            store->Tier(id, k, buckets);
+            for (const HistoryBucket& b : buckets) {
+                w.String(roll_series, name.data(), name.size());
+                w.Int32(roll_width, (int32_t)HistoryStore::kTierMs[k]);
+                w.Int64(roll_t, b.t_ms);
+                w.Float(roll_min, b.min);
+                w.Float(roll_max, b.max);
+                w.Float(roll_avg, b.avg);
+                w.Int32(roll_count, (int32_t)b.count);
+            }
+            rows += buckets.size();
+        }
+    }
+    return true;
+}
+
+bool Export(const std::string& in, const std::string& out, std::string& error, uint64_t& rows) {
+    rows = 0;
+    char magic[8] = {};
+    FILE* f = fopen(in.c_str(), "rb");
+    if (!f) {
+        error = "cannot open " + in + ": " + strerror(errno);
+        return false;
+    }
+    size_t n = fread(magic, 1, sizeof(magic), f);
+    fclose(f);
+
+    ColumnWriter writer;
+    bool ok;
+    if (n == sizeof(magic) && memcmp(magic, "NMREC", 5) == 0) {
+        ok = ExportRecording(in, writer, error, rows);
+    } else if (n == sizeof(magic) && memcmp(magic, "NMHIST", 6) == 0) {
+        ok = ExportHistory(in, writer, error, rows);
+    } else {
+        error = in + ": neither a recording nor a history file";
+        return false;
+    }
+    return ok && writer.Finish(out, error);
+}
+
+}
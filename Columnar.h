@@ -0,0 +1,110 @@
+#ifndef COLUMNAR_H
+#define COLUMNAR_H
+
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdint>
+#include <unordered_map>
+
+// Columnar export files: one typed array per column, each starting on a
+// 64-byte boundary, so a reader maps the file and uses the arrays in place
+// (numpy: np.frombuffer(mm, dtype, rows, offset)). Native byte order; the
+// header's byte_order field reads 0x01020304 on a matching machine.
+//
+//   header   (64 bytes)  char magic[8] "NMCOL001", uint32 version, uint32 columns,
+//                        uint64 file_bytes, uint32 byte_order, uint32 reserved[9]
+//   column   (64 bytes each, right after the header)
+//                        char name[32] (NUL-terminated), uint32 type, uint32 dict_count,
+//                        uint64 rows, uint64 offset, uint64 dict_offset
+//   data     rows values of the column's type at offset
+//   dict     for COLUMN_DICT: uint64 ends[dict_count] at dict_offset, then the
+//            strings back to back (no NULs); string i is bytes [ends[i-1], ends[i])
+//            of that blob, and the column holds uint32 indices into it
+//
+// Columns are grouped into tables by the prefix of their name ("processes.cpu");
+// the columns of a table have the same row count.
+
+enum ColumnType : uint32_t {
+    COLUMN_INT64 = 1,
+    COLUMN_INT32 = 2,
+    COLUMN_FLOAT32 = 3,
+    COLUMN_UINT8 = 4,
+    COLUMN_DICT = 5,
+};
+
+class ColumnWriter {
+public:
+    ColumnWriter() = default;
+    ~ColumnWriter();
+    ColumnWriter(const ColumnWriter&) = delete;
+    ColumnWriter& operator=(const ColumnWriter&) = delete;
+
+    // Index of the new column, -1 if its values cannot be spooled. Values go
+    // to a temporary file per column, so memory does not grow with the rows.
+    int Add(const std::string& name, ColumnType type);
+
+    void Int64(int column, int64_t value) { Put(column, &value, sizeof(value)); }
+    void Int32(int column, int32_t value) { Put(column, &value, sizeof(value)); }
+    void Float(int column, float value) { Put(column, &value, sizeof(value)); }
+    void Byte(int column, uint8_t value) { Put(column, &value, sizeof(value)); }
+    void String(int column, const char* text, size_t len);
+
+    // Writes the file and drops the columns
+    bool Finish(const std::string& path, std::string& error);
+
+private:
+    struct Column {
+        std::string name;
+        ColumnType type;
+        FILE* spool = nullptr;
+        uint64_t rows = 0;
+        std::unordered_map<std::string, uint32_t> codes;
+        std::vector<std::string> strings;   // by code
+    };
+
+    void Put(int column, const void* value, size_t bytes);
+
+    std::vector<Column> columns;
+};
+
+class ColumnFile {
+public:
+    struct Info {
+        std::string name;
+        ColumnType type;
+        uint64_t rows;
+        const void* data;
+        uint32_t dict_count;
+    };
+
+    ColumnFile() = default;
+    ~ColumnFile() { Close(); }
+    ColumnFile(const ColumnFile&) = delete;
+    ColumnFile& operator=(const ColumnFile&) = delete;
+
+    bool Open(const std::string& path, std::string& error);
+    void Close();
+
+    const std::vector<Info>& Columns() const { return columns; }
+    int Find(const std::string& name) const;  // -1 if missing
+    // Entry code of a COLUMN_DICT column's dictionary
+    std::string Text(int column, uint32_t code) const;
+
+private:
+    const uint8_t* map = nullptr;
+    size_t size = 0;
+    std::vector<Info> columns;
+    std::vector<const uint64_t*> ends;  // per column, null unless COLUMN_DICT
+};
+
+namespace Columnar {
+// Exports a session recording (see Recording.h) or a history file (see
+// History.h), told apart by their magic. A recording gives the tables
+// "system" (one row per frame) and "processes" (one row per process sample);
+// a history file gives "history" (raw samples) and "rollup" (the buckets of
+// every tier). rows gets the total row count written.
+bool Export(const std::string& in, const std::string& out, std::string& error, uint64_t& rows);
+}
+
+#endif
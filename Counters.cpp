@@ -0,0 +1,102 @@
+#include "Counters.h"
+#include "Parser.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstring>
+#include <cstdlib>
+
+CounterCollector::CounterCollector() : buf(64 * 1024) {
+    vmstat_fd = open("/proc/vmstat", O_RDONLY | O_CLOEXEC);
+    stat_fd = open("/proc/stat", O_RDONLY | O_CLOEXEC);
+}
+
+CounterCollector::~CounterCollector() {
+    if (vmstat_fd >= 0) close(vmstat_fd);
+    if (stat_fd >= 0) close(stat_fd);
+}
+
+// Both files are "key value..." per line; walk them once without building strings
+static const char* NextLine(const char* p, const char* end) {
+    const char* nl = (const char*)memchr(p, '\n', end - p);
+    return nl ? nl + 1 : end;
+}
+
+static bool KeyIs(const char* p, const char* key, size_t len) {
+    return strncmp(p, key, len) == 0 && p[len] == ' ';
+}
+
+static bool KeyStarts(const char* p, const char* prefix, size_t len) {
+    return strncmp(p, prefix, len) == 0;
+}
+
+void CounterCollector::ParseVmstat(unsigned long long* out) {
+    const char* p = buf.data();
+    const char* end = p + buf_len;
+    for (; p < end; p = NextLine(p, end)) {
+        const char* space = (const char*)memchr(p, ' ', end - p);
+        if (!space) break;
+        unsigned long long v = strtoull(space + 1, nullptr, 10);
+
+        if (KeyIs(p, "pgfault", 7)) out[PGFAULT] = v;
+        else if (KeyIs(p, "pgmajfault", 10)) out[PGMAJFAULT] = v;
+        else if (KeyIs(p, "pswpin", 6)) out[PSWPIN] = v;
+        else if (KeyIs(p, "pswpout", 7)) out[PSWPOUT] = v;
+        else if (KeyIs(p, "oom_kill", 8)) out[OOM_KILL] = v;
+        else if (KeyStarts(p, "pgscan_direct_throttle", 22)) continue; // an event count, not pages
+        // Older kernels split these per zone (pgscan_kswapd_normal, ...), so match by prefix
+        else if (KeyStarts(p, "pgscan_kswapd", 13) || KeyStarts(p, "pgscan_direct", 13) ||
+                 KeyStarts(p, "pgscan_khugepaged", 17)) out[PGSCAN] += v;
+        else if (KeyStarts(p, "pgsteal_kswapd", 14) || KeyStarts(p, "pgsteal_direct", 14) ||
+                 KeyStarts(p, "pgsteal_khugepaged", 18)) out[PGSTEAL] += v;
+    }
+}
+
+void CounterCollector::ParseStat(unsigned long long* out, long& running, long& blocked) {
+    const char* p = buf.data();
+    const char* end = p + buf_len;
+    for (; p < end; p = NextLine(p, end)) {
+        if (p[0] == 'c' && p[1] == 'p' && p[2] == 'u') continue; // cpu lines belong to Parser::GetCpuTimes
+        const char* space = (const char*)memchr(p, ' ', end - p);
+        if (!space) break;
+        unsigned long long v = strtoull(space + 1, nullptr, 10); // for intr: the total, first column
+
+        if (KeyIs(p, "ctxt", 4)) out[CTXT] = v;
+        else if (KeyIs(p, "intr", 4)) out[INTR] = v;
+        else if (KeyIs(p, "processes", 9)) out[PROCESSES] = v;
+        else if (KeyIs(p, "procs_running", 13)) running = (long)v;
+        else if (KeyIs(p, "procs_blocked", 13)) blocked = (long)v;
+    }
+}
+
+KernelActivity CounterCollector::Collect() {
+    unsigned long long now[COUNTER_COUNT] = {};
+    KernelActivity act;
+    memset(&act, 0, sizeof(act));
+
+    if ((buf_len = Parser::ReadWhole(vmstat_fd, buf)) > 0) ParseVmstat(now);
+    if ((buf_len = Parser::ReadWhole(stat_fd, buf)) > 0) ParseStat(now, act.procs_running, act.procs_blocked);
+    std::chrono::steady_clock::time_point t = std::chrono::steady_clock::now();
+
+    if (has_last) {
+        float dt = std::chrono::duration<float>(t - last_time).count();
+        auto rate = [&](Counter c) {
+            if (dt <= 0.0f || now[c] < last[c]) return 0.0f;
+            return (float)(now[c] - last[c]) / dt;
+        };
+        act.pgfault = rate(PGFAULT);
+        act.pgmajfault = rate(PGMAJFAULT);
+        act.pswpin = rate(PSWPIN);
+        act.pswpout = rate(PSWPOUT);
+        act.pgscan = rate(PGSCAN);
+        act.pgsteal = rate(PGSTEAL);
+        act.oom_kill = rate(OOM_KILL);
+        act.ctxt = rate(CTXT);
+        act.intr = rate(INTR);
+        act.forks = rate(PROCESSES);
+    }
+
+    memcpy(last, now, sizeof(last));
+    last_time = t;
+    has_last = true;
+    return act;
+}
@@ -0,0 +1,55 @@
+#ifndef COUNTERS_H
+#define COUNTERS_H
+
+#include <vector>
+#include <chrono>
+
+// System-wide kernel activity from /proc/vmstat and /proc/stat.
+// Rates are per second over the measured interval between two samples.
+struct KernelActivity {
+    float pgfault;
+    float pgmajfault;
+    float pswpin;
+    float pswpout;
+    float pgscan;        // kswapd + direct + khugepaged
+    float pgsteal;
+    float oom_kill;
+
+    float ctxt;          // context switches
+    float intr;          // interrupts (all sources)
+    float forks;         // "processes" line: forks + clones
+
+    long procs_running;  // gauges, not rates
+    long procs_blocked;
+};
+
+class CounterCollector {
+public:
+    CounterCollector();
+    ~CounterCollector();
+    CounterCollector(const CounterCollector&) = delete;
+    CounterCollector& operator=(const CounterCollector&) = delete;
+
+    KernelActivity Collect();
+
+private:
+    enum Counter {
+        PGFAULT, PGMAJFAULT, PSWPIN, PSWPOUT, PGSCAN, PGSTEAL, OOM_KILL,
+        CTXT, INTR, PROCESSES, COUNTER_COUNT
+    };
+
+    void ParseVmstat(unsigned long long* out);
+    void ParseStat(unsigned long long* out, long& running, long& blocked);
+
+    // Kept open for the lifetime of the collector; each sample is a single pread
+    int vmstat_fd = -1;
+    int stat_fd = -1;
+    std::vector<char> buf;
+    size_t buf_len = 0;
+
+    unsigned long long last[COUNTER_COUNT] = {};
+    bool has_last = false;
+    std::chrono::steady_clock::time_point last_time;
+};
+
+#endif
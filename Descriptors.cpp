@@ -0,0 +1,126 @@
+#include "Descriptors.h"
+#include "Parser.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <cstring>
+#include <cstdio>
+#include <algorithm>
+#include <unordered_set>
+
+// Directory entries a single process may consume per sweep. A process with
+// more fds keeps its directory open and continues on the next sweep.
+static const long kPerProcessBudget = 32 * 1024;
+// Directory entries for the whole sweep; the rest of the list resumes next time.
+static const long kSweepBudget = 256 * 1024;
+
+struct linux_dirent64 {
+    uint64_t d_ino;
+    int64_t d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[];
+};
+
+FdCollector::FdCollector() : dents_buf(64 * 1024) {}
+
+FdCollector::~FdCollector() {
+    for (auto& kv : known) Close(kv.second);
+}
+
+void FdCollector::Close(Entry& e) {
+    if (e.dir_fd >= 0) close(e.dir_fd);
+    e.dir_fd = -1;
+    e.partial = 0;
+}
+
+bool FdCollector::CountSome(Entry& e, long budget, long& used) {
+    // Only the entry count matters: no readlink, no stat, just getdents64 record walking
+    while (used < budget) {
+        long n = syscall(SYS_getdents64, e.dir_fd, dents_buf.data(), dents_buf.size());
+        if (n <= 0) return true; // end of directory (or the process exited)
+        for (long off = 0; off < n;) {
+            linux_dirent64* d = (linux_dirent64*)(dents_buf.data() + off);
+            off += d->d_reclen;
+            used++;
+            if (d->d_name[0] == '.' && (d->d_name[1] == '\0' || (d->d_name[1] == '.' && d->d_name[2] == '\0'))) continue;
+            e.partial++;
+        }
+    }
+    return false;
+}
+
+void FdCollector::Collect(const ProcessTable& procs, std::vector<FdUsage>& usage, std::pmr::memory_resource* scratch) {
+    // Forget exited processes
+    std::pmr::unordered_set<int> alive(procs.pid.begin(), procs.pid.end(), procs.Size() * 2, std::hash<int>(), std::equal_to<int>(), scratch);
+    for (auto it = known.begin(); it != known.end();) {
+        if (alive.count(it->first)) { ++it; continue; }
+        Close(it->second);
+        it = known.erase(it);
+    }
+
+    Clock::time_point now = Clock::now();
+    long sweep_used = 0;
+    size_t n = procs.Size();
+    size_t start = n ? cursor % n : 0;
+    for (size_t i = 0; i < n; ++i) {
+        if (sweep_used >= kSweepBudget) {
+            cursor = (start + i) % n;
+            break;
+        }
+        size_t row = (start + i) % n;
+        int pid = procs.pid[row];
+        Entry& e = known[pid];
+
+        // New process or pid reuse: reset and re-read the limit once
+        if (e.starttime != procs.starttime[row]) {
+            Close(e);
+            e = Entry();
+            e.starttime = procs.starttime[row];
+            e.soft_limit = Parser::OpenFileLimit(pid);
+        }
+
+        if (e.dir_fd < 0) {
+            char path[32];
+            snprintf(path, sizeof(path), "/proc/%d/fd", pid);
+            e.dir_fd = open(path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+            if (e.dir_fd < 0) continue; // not ours to read
+            e.partial = 0;
+        }
+
+        long used = 0;
+        long budget = std::min(kPerProcessBudget, kSweepBudget - sweep_used);
+        bool done = CountSome(e, budget, used);
+        sweep_used += used;
+        if (!done) continue;
+
+        if (e.has_count) {
+            float dt = std::chrono::duration<float>(now - e.counted_at).count();
+            if (dt > 0.0f) e.growth_per_sec = (e.partial - e.count) / dt;
+        }
+        e.count = e.partial;
+        e.has_count = true;
+        e.counted_at = now;
+        Close(e);
+    }
+
+    usage.clear();
+    for (const auto& kv : known) {
+        const Entry& e = kv.second;
+        bool counting = e.dir_fd >= 0;
+        if (!e.has_count && !counting) continue;
+
+        FdUsage u;
+        u.pid = kv.first;
+        u.fd_count = e.has_count ? std::max(e.count, e.partial) : e.partial;
+        u.counting = counting;
+        u.soft_limit = e.soft_limit;
+        u.limit_percent = e.soft_limit > 0 ? 100.0f * u.fd_count / e.soft_limit : 0.0f;
+        u.growth_per_sec = e.growth_per_sec;
+        u.near_limit = u.limit_percent >= kFdWarnPercent;
+        usage.push_back(u);
+    }
+    std::sort(usage.begin(), usage.end(), [](const FdUsage& a, const FdUsage& b) {
+        return a.growth_per_sec > b.growth_per_sec;
+    });
+}
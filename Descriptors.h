@@ -0,0 +1,58 @@
+#ifndef DESCRIPTORS_H
+#define DESCRIPTORS_H
+
+#include <vector>
+#include <chrono>
+#include <unordered_map>
+#include <memory_resource>
+#include "ProcessTable.h"
+
+struct FdUsage {
+    int pid;
+    long fd_count;        // last complete count (or the running count while counting is true)
+    bool counting;        // enumeration is spread over several sweeps; fd_count is a lower bound
+    long soft_limit;      // soft RLIMIT_NOFILE, -1 if unlimited or unreadable
+    float limit_percent;  // fd_count / soft_limit * 100, 0 without a limit
+    float growth_per_sec; // fds opened per second since the previous complete count
+    bool near_limit;      // limit_percent >= kFdWarnPercent
+};
+
+// Count at which a process is flagged as close to its RLIMIT_NOFILE
+const float kFdWarnPercent = 80.0f;
+
+class FdCollector {
+public:
+    FdCollector();
+    ~FdCollector();
+    FdCollector(const FdCollector&) = delete;
+    FdCollector& operator=(const FdCollector&) = delete;
+
+    // One sweep over the given processes into `out` (reused), sorted by growth
+    // rate (fastest first). Per-sweep lookups are built in `scratch`.
+    void Collect(const ProcessTable& procs, std::vector<FdUsage>& out, std::pmr::memory_resource* scratch);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Entry {
+        long long starttime = -1;
+        long soft_limit = -1;        // cached for this starttime; /proc/PID/limits is only reread on pid reuse
+        long count = 0;              // last complete count
+        bool has_count = false;
+        Clock::time_point counted_at;
+        float growth_per_sec = 0.0f;
+
+        int dir_fd = -1;             // open while an enumeration is split across sweeps
+        long partial = 0;
+    };
+
+    // Reads up to `budget` dirents; returns true once the directory is exhausted.
+    bool CountSome(Entry& e, long budget, long& used);
+    void Close(Entry& e);
+
+    std::unordered_map<int, Entry> known;
+    std::vector<char> dents_buf;
+    size_t cursor = 0;
+};
+
+#endif
@@ -0,0 +1,55 @@
+#include "Diff.h"
+#include <cmath>
+#include <cstring>
+
+const ProcessDiff& ProcessDiffer::Update(const ProcessTable& current) {
+    diff.Clear();
+    generation++;
+    // A rebuilt pool reassigns handles, so an equal handle proves nothing
+    bool rebuilt = current.pool_generation != pool_generation;
+    pool_generation = current.pool_generation;
+
+    for (size_t i = 0; i < current.Size(); ++i) {
+        int pid = current.pid[i];
+        float cpu = current.cpu[i];
+        auto it = known.find(pid);
+        if (it == known.end() || it->second.starttime != current.starttime[i]) {
+            if (it != known.end()) diff.removed.push_back(pid); // pid reuse
+            known[pid] = Record{current.starttime[i], cpu, current.rss_mb[i], current.command[i], current.Command(i), generation};
+            diff.added.push_back(i);
+            continue;
+        }
+
+        Record& r = it->second;
+        r.seen = generation;
+        uint32_t dirty = 0;
+        if (std::fabs(cpu - r.cpu) > cpu_epsilon || (cpu == 0.0f) != (r.cpu == 0.0f)) {
+            dirty |= FIELD_CPU;
+            r.cpu = cpu;
+        }
+        if (current.rss_mb[i] != r.memory) {
+            dirty |= FIELD_MEMORY;
+            r.memory = current.rss_mb[i];
+        }
+        // Handles are stable while the producer's pool is, so the string is
+        // only compared when the handle moved or the pool was rebuilt
+        if (rebuilt || current.command[i] != r.command_handle) {
+            r.command_handle = current.command[i];
+            if (strcmp(current.Command(i), r.command.c_str()) != 0) {
+                dirty |= FIELD_COMMAND;
+                r.command = current.Command(i);
+            }
+        }
+        if (dirty) diff.changed.push_back({i, dirty});
+    }
+
+    for (auto it = known.begin(); it != known.end();) {
+        if (it->second.seen == generation) {
+            ++it;
+            continue;
+        }
+        diff.removed.push_back(it->first);
+        it = known.erase(it);
+    }
+    return diff;
+}
@@ -0,0 +1,64 @@
+#ifndef DIFF_H
+#define DIFF_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <unordered_map>
+#include "ProcessTable.h"
+
+// Per-field dirty bits of a changed process
+enum ProcessField : uint32_t {
+    FIELD_CPU = 1u << 0,
+    FIELD_MEMORY = 1u << 1,
+    FIELD_COMMAND = 1u << 2,
+};
+
+struct ProcessChange {
+    size_t index;    // row of the table passed to ProcessDiffer::Update()
+    uint32_t dirty;  // ProcessField bits
+};
+
+// Difference between two consecutive process lists. A pid reused by a new
+// process (different starttime) appears in both removed and added.
+struct ProcessDiff {
+    std::vector<size_t> added;          // rows of the current table
+    std::vector<int> removed;           // pids
+    std::vector<ProcessChange> changed;
+
+    bool Empty() const { return added.empty() && removed.empty() && changed.empty(); }
+    void Clear() { added.clear(); removed.clear(); changed.clear(); }
+};
+
+// Compares each process list with the previous one, so consumers can update
+// sort order, history, alerts and output from the churn instead of redoing
+// the whole list. Keeps one small record per live process.
+class ProcessDiffer {
+public:
+    // CPU moves below this many percentage points are not reported
+    explicit ProcessDiffer(float cpu_epsilon = 0.0f) : cpu_epsilon(cpu_epsilon) {}
+
+    const ProcessDiff& Update(const ProcessTable& current);
+    void Reset() {
+        known.clear();
+        pool_generation = 0;
+    }
+
+private:
+    struct Record {
+        long long starttime;
+        float cpu;           // as last reported, so small drifts add up
+        float memory;
+        uint32_t command_handle; // into the previous table's strings; usually unchanged
+        std::string command;
+        uint64_t seen;       // generation of the last Update() that listed it
+    };
+
+    float cpu_epsilon;
+    uint64_t generation = 0;
+    uint32_t pool_generation = 0;  // of the previous table
+    std::unordered_map<int, Record> known;
+    ProcessDiff diff;
+};
+
+#endif
@@ -0,0 +1,192 @@
+#include "Gorilla.h"
+#include <cstring>
+#include <cstddef>
+
+// Worst case of one sample after the first: '1111' + 64-bit dod, then per column '11' + 5 + 5 + 32 value bits
+static const uint32_t kMaxTimeBits = 4 + 64;
+static const uint32_t kMaxValueBits = 2 + 5 + 5 + 32;
+static const uint32_t kCapacityBits = HistoryChunk::kDataBytes * 8;
+
+static int ClampColumns(int columns) { return columns < 1 ? 1 : columns > kMaxColumns ? kMaxColumns : columns; }
+
+// --- ENCODER ---
+void ChunkEncoder::Start(HistoryChunk& target, int n) {
+    memset(&target, 0, sizeof(target));
+    chunk = &target;
+    columns = ClampColumns(n);
+    prev_t = prev_delta = 0;
+    for (ColumnState& c : col) c = ColumnState();
+}
+
+uint32_t ChunkChecksum(const HistoryChunk& chunk) {
+    uint32_t hash = 2166136261u;
+    auto mix = [&hash](const void* p, size_t n) {
+        const uint8_t* b = (const uint8_t*)p;
+        for (size_t i = 0; i < n; ++i) hash = (hash ^ b[i]) * 16777619u;
+    };
+    mix(&chunk, offsetof(HistoryChunk, checksum));
+    size_t bytes = (chunk.bits + 7) / 8;
+    mix(chunk.data, bytes < HistoryChunk::kDataBytes ? bytes : HistoryChunk::kDataBytes);
+    return hash;
+}
+
+bool ChunkEncoder::Resume(HistoryChunk& target, int n_columns) {
+    chunk = &target;
+    columns = ClampColumns(n_columns);
+    if (target.bits > kCapacityBits) return false;
+    ChunkDecoder decoder(target, columns);
+    int64_t t, last = 0;
+    float v[kMaxColumns];
+    uint32_t n = 0;
+    while (decoder.Next(t, v)) {
+        if (n == 0 ? t != target.first_t : t < last) return false;
+        last = t;
+        n++;
+    }
+    if (n != target.count) return false;
+    // A torn append leaves bits past the last whole sample; Write() ORs into
+    // a zeroed tail, so clear them
+    target.bits = decoder.pos;
+    size_t byte = target.bits >> 3;
+    if (target.bits & 7) target.data[byte++] &= (uint8_t)(0xFF00 >> (target.bits & 7));
+    memset(target.data + byte, 0, HistoryChunk::kDataBytes - byte);
+    if (n > 0) target.last_t = last;
+    prev_t = decoder.prev_t;
+    prev_delta = decoder.prev_delta;
+    for (int i = 0; i < kMaxColumns; ++i) col[i] = decoder.col[i];
+    return true;
+}
+
+void ChunkEncoder::Write(uint64_t bits, int n) {
+    // Bytes start zeroed, so each piece is ORed into place
+    uint32_t& pos = chunk->bits;
+    while (n > 0) {
+        int free = 8 - (int)(pos & 7);
+        int take = n < free ? n : free;
+        uint64_t piece = (bits >> (n - take)) & ((1u << take) - 1);
+        chunk->data[pos >> 3] |= (uint8_t)(piece << (free - take));
+        pos += take;
+        n -= take;
+    }
+}
+
+bool ChunkEncoder::Append(int64_t t_ms, const float* values) {
+    uint32_t worst = chunk->count == 0 ? 64 + 32 * columns : kMaxTimeBits + kMaxValueBits * columns;
+    if (chunk->bits + worst > kCapacityBits) return false;
+
+    if (chunk->count == 0) {
+        Write((uint64_t)t_ms, 64);
+        chunk->first_t = t_ms;
+    } else {
+        int64_t delta = t_ms - prev_t;
+        int64_t dod = delta - prev_delta;
+        if (dod == 0) {
+            Write(0, 1);
+        } else if (dod >= -63 && dod <= 64) {
+            Write(0x2, 2);
+            Write((uint64_t)(dod + 63), 7);
+        } else if (dod >= -255 && dod <= 256) {
+            Write(0x6, 3);
+            Write((uint64_t)(dod + 255), 9);
+        } else if (dod >= -2047 && dod <= 2048) {
+            Write(0xE, 4);
+            Write((uint64_t)(dod + 2047), 12);
+        } else {
+            Write(0xF, 4);
+            Write((uint64_t)dod, 64);
+        }
+        prev_delta = delta;
+    }
+
+    for (int i = 0; i < columns; ++i) {
+        ColumnState& c = col[i];
+        uint32_t bits;
+        memcpy(&bits, &values[i], sizeof(bits));
+        if (chunk->count == 0) {
+            Write(bits, 32);
+            c.value = bits;
+            continue;
+        }
+        uint32_t x = bits ^ c.value;
+        if (x == 0) {
+            Write(0, 1);
+        } else {
+            int leading = __builtin_clz(x);
+            int trailing = __builtin_ctz(x);
+            if (c.leading >= 0 && leading >= c.leading && trailing >= c.trailing) {
+                Write(0x2, 2);
+                Write(x >> c.trailing, 32 - c.leading - c.trailing);
+            } else {
+                int length = 32 - leading - trailing;
+                Write(0x3, 2);
+                Write((uint64_t)leading, 5);
+                Write((uint64_t)(length - 1), 5);
+                Write(x >> trailing, length);
+                c.leading = leading;
+                c.trailing = trailing;
+            }
+        }
+        c.value = bits;
+    }
+    prev_t = t_ms;
+    chunk->last_t = t_ms;
+    chunk->count++;
+    return true;
+}
+
+// --- DECODER ---
+uint64_t ChunkDecoder::Read(int n) {
+    if (n == 0) return 0;
+    if (n > 56) {
+        uint64_t high = Read(n - 32);
+        return (high << 32) | Read(32);
+    }
+    // One unaligned 64-bit load covers any n <= 56 at any bit offset
+    size_t byte = pos >> 3;
+    uint64_t w = 0;
+    if (byte + 8 <= HistoryChunk::kDataBytes) {
+        memcpy(&w, chunk.data + byte, sizeof(w));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        w = __builtin_bswap64(w);
+#endif
+    } else {
+        for (size_t i = 0; i < 8; ++i) w = (w << 8) | (byte + i < HistoryChunk::kDataBytes ? chunk.data[byte + i] : 0);
+    }
+    w = (w << (pos & 7)) >> (64 - n);
+    pos += n;
+    return w;
+}
+
+bool ChunkDecoder::Next(int64_t& t_ms, float* values) {
+    if (index >= chunk.count) return false;
+    if (index == 0) {
+        prev_t = (int64_t)Read(64);
+        for (int i = 0; i < columns; ++i) col[i].value = (uint32_t)Read(32);
+    } else {
+        int64_t dod;
+        if (Read(1) == 0) dod = 0;
+        else if (Read(1) == 0) dod = (int64_t)Read(7) - 63;
+        else if (Read(1) == 0) dod = (int64_t)Read(9) - 255;
+        else if (Read(1) == 0) dod = (int64_t)Read(12) - 2047;
+        else dod = (int64_t)Read(64);
+        prev_delta += dod;
+        prev_t += prev_delta;
+
+        for (int i = 0; i < columns; ++i) {
+            ColumnState& c = col[i];
+            if (Read(1) == 0) continue;
+            if (Read(1) == 1) {
+                c.leading = (int)Read(5);
+                int length = (int)Read(5) + 1;
+                c.trailing = 32 - c.leading - length;
+            }
+            if (c.leading < 0 || c.trailing < 0) return false; // corrupt window
+            c.value ^= (uint32_t)Read(32 - c.leading - c.trailing) << c.trailing;
+        }
+    }
+    if (pos > chunk.bits) return false; // ran past the written bits: count and data disagree
+    index++;
+    t_ms = prev_t;
+    for (int i = 0; i < columns; ++i) memcpy(&values[i], &col[i].value, sizeof(float));
+    return true;
+}
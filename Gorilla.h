@@ -0,0 +1,97 @@
+#ifndef GORILLA_H
+#define GORILLA_H
+
+#include <cstdint>
+#include <cstddef>
+
+// Fixed-size block of compressed (timestamp, value) samples, in the format of
+// Facebook's Gorilla TSDB: timestamps as delta-of-delta, values XORed with
+// their predecessor. Plain data, so a chunk can be copied or mapped as is.
+//
+// Bit stream, most significant bit first:
+//   sample 0:  t (64 bits), value (32 bits, IEEE float)
+//   sample n:  delta-of-delta of t in ms
+//                '0'                          dod == 0
+//                '10'   + 7 bits (dod + 63)   -63 .. 64
+//                '110'  + 9 bits (dod + 255)  -255 .. 256
+//                '1110' + 12 bits (dod + 2047) -2047 .. 2048
+//                '1111' + 64 bits             anything else
+//              then value XOR previous value
+//                '0'                          identical
+//                '10'  + meaningful bits      fits the previous leading/trailing-zero window
+//                '11'  + 5 bits leading zeros + 5 bits (length - 1) + length bits
+// A chunk may hold up to kMaxColumns values per timestamp (rollups keep
+// min/max/avg/count): each column is then XORed against its own predecessor,
+// in column order after the timestamp. The column count is not stored; the
+// chunk's owner passes the same one to the encoder and decoder.
+struct HistoryChunk {
+    static constexpr size_t kBytes = 512;
+    static constexpr size_t kHeaderBytes = 32;
+    static constexpr size_t kDataBytes = kBytes - kHeaderBytes;
+
+    int64_t first_t;  // ms; valid when count > 0
+    int64_t last_t;
+    uint32_t count;   // samples
+    uint32_t bits;    // bits of data in use
+    uint32_t seq;     // position in its series, kept by the owner; 0 = never used
+    uint32_t checksum; // ChunkChecksum() as of the owner's last seal or flush
+    uint8_t data[kDataBytes];
+};
+static_assert(sizeof(HistoryChunk) == HistoryChunk::kBytes, "HistoryChunk must stay a fixed, packed size");
+
+// FNV-1a over the header (minus the checksum itself) and the data bits in use
+uint32_t ChunkChecksum(const HistoryChunk& chunk);
+
+static constexpr int kMaxColumns = 4;
+
+// XOR state of one value column
+struct ColumnState {
+    uint32_t value = 0;
+    int leading = -1;   // window of the last '11' value; -1 before the first
+    int trailing = 0;
+};
+
+// Streaming encoder into one chunk
+class ChunkEncoder {
+public:
+    void Start(HistoryChunk& chunk, int columns = 1);   // empties the chunk (seq included)
+    // Continues a chunk written earlier. Decodes its `count` samples and, if
+    // they are consistent, trims `bits` and `last_t` to them (a writer that
+    // died mid-append leaves either one ahead) and returns true.
+    bool Resume(HistoryChunk& chunk, int columns = 1);
+    // One value per column; false if the chunk is full, and the sample is then not written
+    bool Append(int64_t t_ms, const float* values);
+    bool Append(int64_t t_ms, float value) { return Append(t_ms, &value); }
+
+private:
+    void Write(uint64_t bits, int n);
+
+    HistoryChunk* chunk = nullptr;
+    int columns = 1;
+    int64_t prev_t = 0;
+    int64_t prev_delta = 0;
+    ColumnState col[kMaxColumns];
+};
+
+// Sequential decoder over one chunk
+class ChunkDecoder {
+public:
+    explicit ChunkDecoder(const HistoryChunk& chunk, int columns = 1) : chunk(chunk), columns(columns) {}
+    bool Next(int64_t& t_ms, float* values);
+    bool Next(int64_t& t_ms, float& value) { return Next(t_ms, &value); }
+
+private:
+    uint64_t Read(int n);
+
+    friend class ChunkEncoder; // Resume() takes over the decoder's state
+
+    const HistoryChunk& chunk;
+    int columns;
+    uint32_t index = 0;
+    uint32_t pos = 0;        // bit offset
+    int64_t prev_t = 0;
+    int64_t prev_delta = 0;
+    ColumnState col[kMaxColumns];
+};
+
+#endif
@@ -0,0 +1,542 @@
+#include "History.h"
+#include <algorithm>
+#include <cstring>
+#include <cstddef>
+#include <climits>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/file.h>
+
+// --- FILE LAYOUT ---
+struct HistoryStore::FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t chunk_bytes;
+    uint64_t file_bytes;
+    uint64_t chunks_offset;   // page-aligned
+    uint32_t chunk_count;
+    uint32_t dir_entries;
+    uint32_t checksum;        // over everything above
+    uint32_t reserved;
+};
+
+struct HistoryStore::DirEntry {
+    char name[kMaxName + 1];
+    uint32_t first;           // index into the chunk area; the rings follow each other from here
+    uint32_t chunks[1 + kTiers]; // raw ring, then each tier's
+    uint32_t checksum;        // over name, first and chunks
+    uint32_t sealed;          // kSealed, written last
+};
+
+static const char kMagic[8] = {'N', 'M', 'H', 'I', 'S', 'T', 0, 0};
+static const uint32_t kVersion = 2;
+static const uint32_t kSealed = 0x5EA1ED01;
+
+static uint32_t Fnv1a(const void* p, size_t n) {
+    uint32_t hash = 2166136261u;
+    const uint8_t* b = (const uint8_t*)p;
+    for (size_t i = 0; i < n; ++i) hash = (hash ^ b[i]) * 16777619u;
+    return hash;
+}
+
+static size_t PageSize() {
+    long page = sysconf(_SC_PAGESIZE);
+    return page > 0 ? (size_t)page : 4096;
+}
+
+// Series take whole pages, so no two series share a page of the file
+static size_t ChunksPerPage() {
+    size_t n = PageSize() / sizeof(HistoryChunk);
+    return n ? n : 1;
+}
+
+HistoryStore::HistoryStore(size_t budget_bytes, const std::string& file) : path(file) {
+    if (Map(budget_bytes)) return;
+    budget = 0; // no mapping at all: every Register() fails
+}
+
+HistoryStore::~HistoryStore() {
+    if (!map) return;
+    Flush();
+    munmap(map, map_bytes);
+    if (fd >= 0) close(fd);
+}
+
+bool HistoryStore::Map(size_t budget_bytes) {
+    static_assert(sizeof(DirEntry) % 8 == 0, "directory entries stay 8-byte aligned");
+    size_t page = PageSize();
+    size_t chunk_count = budget_bytes / sizeof(HistoryChunk) / ChunksPerPage() * ChunksPerPage();
+    size_t dir_entries = std::max<size_t>(64, chunk_count / 8);
+    size_t chunks_offset = (sizeof(FileHeader) + dir_entries * sizeof(DirEntry) + page - 1) / page * page;
+    size_t file_bytes = chunks_offset + chunk_count * sizeof(HistoryChunk);
+    if (chunk_count == 0 || chunk_count > UINT32_MAX) return false;
+
+    bool fresh = true;
+    if (!path.empty()) {
+        fd = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        struct stat st;
+        if (fd < 0) {
+            error = std::string("cannot open: ") + strerror(errno);
+        } else if (flock(fd, LOCK_EX | LOCK_NB) != 0) {
+            error = "in use by another instance";
+        } else if (fstat(fd, &st) != 0) {
+            error = std::string("cannot stat: ") + strerror(errno);
+        } else {
+            fresh = (size_t)st.st_size != file_bytes;
+            // Recreated rather than resized: the layout depends on the size
+            if (fresh && (ftruncate(fd, 0) != 0 || ftruncate(fd, (off_t)file_bytes) != 0)) {
+                error = std::string("cannot size: ") + strerror(errno);
+            } else {
+                void* p = mmap(nullptr, file_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+                if (p == MAP_FAILED) error = std::string("cannot map: ") + strerror(errno);
+                else map = (uint8_t*)p;
+            }
+        }
+        if (!map && fd >= 0) {
+            close(fd);
+            fd = -1;
+        }
+    }
+    if (!map) {
+        fresh = true;
+        void* p = mmap(nullptr, file_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (p == MAP_FAILED) return false;
+        map = (uint8_t*)p;
+    }
+    map_bytes = file_bytes;
+    budget = chunk_count * sizeof(HistoryChunk);
+    header = (FileHeader*)map;
+    directory = (DirEntry*)(map + sizeof(FileHeader));
+    area = (HistoryChunk*)(map + chunks_offset);
+
+    FileHeader expected;
+    memset(&expected, 0, sizeof(expected));
+    memcpy(expected.magic, kMagic, sizeof(kMagic));
+    expected.version = kVersion;
+    expected.chunk_bytes = sizeof(HistoryChunk);
+    expected.file_bytes = file_bytes;
+    expected.chunks_offset = chunks_offset;
+    expected.chunk_count = (uint32_t)chunk_count;
+    expected.dir_entries = (uint32_t)dir_entries;
+    expected.checksum = Fnv1a(&expected, offsetof(FileHeader, checksum));
+    if (!fresh && memcmp(header, &expected, sizeof(expected)) == 0) {
+        Recover();
+    } else {
+        // Directory first, header last: a crash in between leaves a file that fails the check above
+        memset(directory, 0, dir_entries * sizeof(DirEntry));
+        memcpy(header, &expected, sizeof(expected));
+    }
+    return true;
+}
+
+std::unique_ptr<HistoryStore> HistoryStore::OpenReadOnly(const std::string& file) {
+    std::unique_ptr<HistoryStore> store(new HistoryStore(0)); // maps nothing
+    store->path = file;
+    store->MapReadOnly();
+    return store;
+}
+
+bool HistoryStore::MapReadOnly() {
+    int file = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (file < 0) {
+        error = std::string("cannot open: ") + strerror(errno);
+        return false;
+    }
+    FileHeader h;
+    struct stat st;
+    bool valid = pread(file, &h, sizeof(h), 0) == (ssize_t)sizeof(h) && fstat(file, &st) == 0 &&
+                 memcmp(h.magic, kMagic, sizeof(kMagic)) == 0 && h.version == kVersion &&
+                 h.checksum == Fnv1a(&h, offsetof(FileHeader, checksum)) && h.chunk_bytes == sizeof(HistoryChunk) &&
+                 h.file_bytes == (uint64_t)st.st_size && h.chunks_offset >= sizeof(FileHeader) + (uint64_t)h.dir_entries * sizeof(DirEntry) &&
+                 h.chunks_offset + (uint64_t)h.chunk_count * sizeof(HistoryChunk) <= h.file_bytes;
+    if (!valid) {
+        error = "not a history file, or from another version";
+        close(file);
+        return false;
+    }
+    // Recovery rewrites head chunks in place; MAP_PRIVATE keeps that out of the file
+    void* p = mmap(nullptr, h.file_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+    close(file);
+    if (p == MAP_FAILED) {
+        error = std::string("cannot map: ") + strerror(errno);
+        return false;
+    }
+    map = (uint8_t*)p;
+    map_bytes = h.file_bytes;
+    budget = (size_t)h.chunk_count * sizeof(HistoryChunk);
+    header = (FileHeader*)map;
+    directory = (DirEntry*)(map + sizeof(FileHeader));
+    area = (HistoryChunk*)(map + h.chunks_offset);
+    Recover();
+    // No room for new series: they would not reach the file
+    header->dir_entries = (uint32_t)series.size();
+    return true;
+}
+
+// --- RINGS ---
+void HistoryStore::Push(Ring& ring, int64_t t_ms, const float* values) {
+    if (!ring.encoder.Append(t_ms, values)) {
+        // Newest chunk is full: seal it, and the next one becomes the head,
+        // dropping the oldest when the ring is full
+        HistoryChunk& full = ring.chunks[ring.head];
+        full.checksum = ChunkChecksum(full);
+        uint32_t seq = full.seq + 1;
+        ring.head = (ring.head + 1) % ring.size;
+        if (ring.used < ring.size) ring.used++;
+        ring.encoder.Start(ring.chunks[ring.head], ring.columns);
+        ring.chunks[ring.head].seq = seq;
+        ring.encoder.Append(t_ms, values);
+    }
+    ring.dirty = true;
+}
+
+// Calls each(t, values) for the samples of [from_ms, to_ms], oldest first
+template <typename F>
+void HistoryStore::Scan(const Ring& ring, int64_t from_ms, int64_t to_ms, F each) {
+    // First chunk whose last sample reaches from_ms
+    size_t lo = 0, hi = ring.used;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        const HistoryChunk& c = ring.Oldest(mid);
+        if (c.count > 0 && c.last_t < from_ms) lo = mid + 1;
+        else hi = mid;
+    }
+    float values[kMaxColumns];
+    int64_t t;
+    for (size_t i = lo; i < ring.used; ++i) {
+        const HistoryChunk& c = ring.Oldest(i);
+        if (c.count == 0 || c.first_t > to_ms) break;
+        ChunkDecoder decoder(c, ring.columns);
+        while (decoder.Next(t, values)) {
+            if (t > to_ms) return;
+            if (t >= from_ms) each(t, values);
+        }
+    }
+}
+
+// Folds a raw sample (tier 0) or a closed bucket of the tier below into the
+// open bucket of tier, closing that one first if t_ms is past it
+void HistoryStore::Fold(Series& s, int tier, int64_t t_ms, float min, float max, double sum, uint32_t count, bool cascade) {
+    OpenBucket& b = s.open[tier];
+    int64_t start = t_ms - t_ms % kTierMs[tier];
+    if (b.count > 0 && b.t_ms != start) {
+        float values[4] = {b.min, b.max, (float)(b.sum / b.count), (float)b.count};
+        Push(s.tier[tier], b.t_ms, values);
+        s.closed[tier] = b.t_ms;
+        if (cascade && tier + 1 < kTiers) Fold(s, tier + 1, b.t_ms, b.min, b.max, b.sum, b.count, true);
+        b.count = 0;
+    }
+    if (b.count == 0) {
+        b = {start, min, max, sum, count};
+        return;
+    }
+    if (min < b.min) b.min = min;
+    if (max > b.max) b.max = max;
+    b.sum += sum;
+    b.count += count;
+}
+
+// --- RECOVERY ---
+void HistoryStore::Recover() {
+    for (uint32_t i = 0; i < header->dir_entries; ++i) {
+        const DirEntry& e = directory[i];
+        // Entries are appended in order; the first one not sealed ends the directory
+        if (e.sealed != kSealed || e.checksum != Fnv1a(&e, offsetof(DirEntry, checksum))) break;
+        size_t total = 0;
+        bool empty = false;
+        for (uint32_t n : e.chunks) {
+            total += n;
+            empty |= n == 0;
+        }
+        if (e.name[kMaxName] != '\0' || empty || e.first < next_chunk || (size_t)e.first + total > header->chunk_count) break;
+
+        std::unique_ptr<Series> s(new Series());
+        s->name = e.name;
+        Layout(*s, e.first, e.chunks);
+        Open(*s);
+        next_chunk = (size_t)e.first + total;
+        used += total * sizeof(HistoryChunk);
+        index.emplace(s->name, (int)series.size());
+        series.push_back(std::move(s));
+    }
+    recovered = series.size();
+}
+
+void HistoryStore::Layout(Series& s, size_t first, const uint32_t* sizes) {
+    Ring* rings[1 + kTiers] = {&s.raw, &s.tier[0], &s.tier[1], &s.tier[2], &s.tier[3]};
+    for (int i = 0; i <= kTiers; ++i) {
+        rings[i]->chunks = area + first;
+        rings[i]->size = sizes[i];
+        rings[i]->columns = i == 0 ? 1 : 4;
+        first += sizes[i];
+    }
+}
+
+// Rebuilds the ring's head and extent from the chunks' sequence numbers and
+// checksums; false if it holds no samples
+bool HistoryStore::OpenRing(Ring& r, int64_t& last_t, float* last_values) {
+    size_t newest = r.size;
+    uint32_t top = 0;
+    for (size_t i = 0; i < r.size; ++i) {
+        if (r.chunks[i].seq > top) {
+            top = r.chunks[i].seq;
+            newest = i;
+        }
+    }
+    if (newest == r.size) {
+        r.encoder.Start(r.chunks[0], r.columns);
+        r.chunks[0].seq = 1;
+        r.head = 0;
+        r.used = 1;
+        r.dirty = true;
+        return false;
+    }
+
+    // The newest chunk was most likely appended to after its last checksum,
+    // so it is judged by decoding instead; one that does not decode is emptied
+    HistoryChunk& head = r.chunks[newest];
+    if (!r.encoder.Resume(head, r.columns)) {
+        r.encoder.Start(head, r.columns);
+        head.seq = top;
+    }
+    head.checksum = ChunkChecksum(head);
+    r.head = newest;
+    r.used = 1;
+    while (r.used < r.size) {
+        const HistoryChunk& c = r.chunks[(newest + r.size - r.used) % r.size];
+        if (c.count == 0 || c.seq != top - r.used || c.checksum != ChunkChecksum(c)) break;
+        r.used++;
+    }
+    for (size_t i = r.used; i-- > 0;) {
+        const HistoryChunk& c = r.Oldest(i);
+        if (c.count == 0) continue;
+        ChunkDecoder decoder(c, r.columns);
+        while (decoder.Next(last_t, last_values)) {}
+        return true;
+    }
+    return false;
+}
+
+void HistoryStore::Open(Series& s) {
+    OpenRing(s.raw, s.last.t_ms, &s.last.value);
+    for (int k = 0; k < kTiers; ++k) {
+        float values[kMaxColumns];
+        OpenRing(s.tier[k], s.closed[k], values);
+        // Refill the open bucket from what the finer ring holds past the last closed one
+        int64_t from = s.closed[k] == INT64_MIN ? INT64_MIN : s.closed[k] + kTierMs[k];
+        if (k == 0) {
+            Scan(s.raw, from, INT64_MAX, [&](int64_t t, const float* v) { Fold(s, 0, t, v[0], v[0], v[0], 1, false); });
+        } else {
+            Scan(s.tier[k - 1], from, INT64_MAX, [&](int64_t t, const float* v) {
+                Fold(s, k, t, v[0], v[1], (double)v[2] * v[3], (uint32_t)v[3], false);
+            });
+        }
+    }
+}
+
+// --- SERIES ---
+int HistoryStore::Register(const std::string& name, size_t chunks) {
+    std::lock_guard<std::mutex> guard(lock);
+    auto it = index.find(name);
+    if (it != index.end()) return it->second;
+    if (!map || name.size() > kMaxName) {
+        rejected++;
+        return kNoSeries;
+    }
+    if (chunks == 0) chunks = kDefaultChunks;
+    uint32_t sizes[1 + kTiers];
+    size_t total = 0;
+    for (int i = 0; i <= kTiers; ++i) {
+        size_t n = i == 0 ? chunks : std::max<size_t>(1, (chunks * kTierEighths[i - 1] + 7) / 8);
+        sizes[i] = (uint32_t)n;
+        total += n;
+    }
+    // Whole pages per series; the slack goes to the raw ring
+    size_t rounded = (total + ChunksPerPage() - 1) / ChunksPerPage() * ChunksPerPage();
+    sizes[0] += (uint32_t)(rounded - total);
+    total = rounded;
+    if (series.size() >= header->dir_entries || next_chunk + total > header->chunk_count) {
+        rejected++;
+        return kNoSeries;
+    }
+
+    std::unique_ptr<Series> s(new Series());
+    s->name = name;
+    memset(area + next_chunk, 0, total * sizeof(HistoryChunk)); // stale seqs would confuse recovery
+    Layout(*s, next_chunk, sizes);
+    Ring* rings[1 + kTiers] = {&s->raw, &s->tier[0], &s->tier[1], &s->tier[2], &s->tier[3]};
+    for (Ring* r : rings) {
+        r->encoder.Start(r->chunks[0], r->columns);
+        r->chunks[0].seq = 1;
+        r->used = 1;
+        r->dirty = true;
+    }
+
+    DirEntry& e = directory[series.size()];
+    memset(&e, 0, sizeof(e));
+    memcpy(e.name, name.data(), name.size());
+    e.first = (uint32_t)next_chunk;
+    memcpy(e.chunks, sizes, sizeof(sizes));
+    e.checksum = Fnv1a(&e, offsetof(DirEntry, checksum));
+    e.sealed = kSealed;
+
+    next_chunk += total;
+    used += total * sizeof(HistoryChunk);
+    int id = (int)series.size();
+    series.push_back(std::move(s));
+    index.emplace(name, id);
+    return id;
+}
+
+int HistoryStore::Find(const std::string& name) const {
+    std::lock_guard<std::mutex> guard(lock);
+    auto it = index.find(name);
+    return it != index.end() ? it->second : kNoSeries;
+}
+
+void HistoryStore::Append(int id, int64_t t_ms, float value) {
+    if (id < 0) return;
+    std::lock_guard<std::mutex> guard(lock);
+    if (id >= (int)series.size()) return;
+    Series& s = *series[id];
+    if (t_ms < s.last.t_ms) return; // keeps chunks in time order
+    Push(s.raw, t_ms, &value);
+    s.last = {t_ms, value};
+    Fold(s, 0, t_ms, value, value, value, 1, true);
+}
+
+bool HistoryStore::Latest(int id, HistorySample& out) const {
+    std::lock_guard<std::mutex> guard(lock);
+    if (id < 0 || id >= (int)series.size()) return false;
+    const Series& s = *series[id];
+    if (s.last.t_ms == INT64_MIN) return false;
+    out = s.last;
+    return true;
+}
+
+size_t HistoryStore::Range(int id, int64_t from_ms, int64_t to_ms, std::vector<HistorySample>& out) const {
+    out.clear();
+    std::lock_guard<std::mutex> guard(lock);
+    if (id < 0 || id >= (int)series.size()) return 0;
+    Scan(series[id]->raw, from_ms, to_ms, [&](int64_t t, const float* v) { out.push_back({t, v[0]}); });
+    return out.size();
+}
+
+size_t HistoryStore::Range(int id, int64_t from_ms, int64_t to_ms, int64_t resolution_ms, std::vector<HistoryBucket>& out,
+                           int64_t* width_ms) const {
+    out.clear();
+    if (width_ms) *width_ms = 0;
+    std::lock_guard<std::mutex> guard(lock);
+    if (id < 0 || id >= (int)series.size()) return 0;
+    const Series& s = *series[id];
+    int tier = -1;
+    while (tier + 1 < kTiers && kTierMs[tier + 1] <= resolution_ms) tier++;
+    // A full ring has dropped its oldest chunks; if it no longer reaches
+    // from_ms, a coarser tier covers more of the range
+    auto short_of = [from_ms](const Ring& r) { return r.used == r.size && r.Oldest(0).first_t > from_ms; };
+    while (tier + 1 < kTiers && short_of(tier < 0 ? s.raw : s.tier[tier])) tier++;
+    if (tier < 0) {
+        Scan(s.raw, from_ms, to_ms, [&](int64_t t, const float* v) { out.push_back({t, v[0], v[0], v[0], 1}); });
+        return out.size();
+    }
+    if (width_ms) *width_ms = kTierMs[tier];
+    // A bucket overlapping from_ms starts before it
+    int64_t from = from_ms > INT64_MIN + kTierMs[tier] ? from_ms - kTierMs[tier] + 1 : from_ms;
+    Scan(s.tier[tier], from, to_ms, [&](int64_t t, const float* v) { out.push_back({t, v[0], v[1], v[2], (uint32_t)v[3]}); });
+    // The open buckets of the finer tiers have not reached this one yet; they
+    // fall in its open bucket or the one after
+    OpenBucket tail[2];
+    int n = 0;
+    for (int k = tier; k >= 0; --k) {
+        const OpenBucket& f = s.open[k];
+        if (f.count == 0) continue;
+        int64_t start = f.t_ms - f.t_ms % kTierMs[tier];
+        if (n == 0 || tail[n - 1].t_ms != start) {
+            if (n == 2) break;
+            tail[n++] = {start, f.min, f.max, f.sum, f.count};
+            continue;
+        }
+        OpenBucket& b = tail[n - 1];
+        if (f.min < b.min) b.min = f.min;
+        if (f.max > b.max) b.max = f.max;
+        b.sum += f.sum;
+        b.count += f.count;
+    }
+    for (int i = 0; i < n; ++i) {
+        const OpenBucket& b = tail[i];
+        if (b.t_ms <= to_ms && b.t_ms >= from) out.push_back({b.t_ms, b.min, b.max, (float)(b.sum / b.count), b.count});
+    }
+    return out.size();
+}
+
+size_t HistoryStore::Tier(int id, int k, std::vector<HistoryBucket>& out) const {
+    out.clear();
+    std::lock_guard<std::mutex> guard(lock);
+    if (id < 0 || id >= (int)series.size() || k < 0 || k >= kTiers) return 0;
+    const Series& s = *series[id];
+    Scan(s.tier[k], INT64_MIN, INT64_MAX, [&](int64_t t, const float* v) { out.push_back({t, v[0], v[1], v[2], (uint32_t)v[3]}); });
+    const OpenBucket& b = s.open[k];
+    if (b.count > 0) out.push_back({b.t_ms, b.min, b.max, (float)(b.sum / b.count), b.count});
+    return out.size();
+}
+
+std::vector<std::string> HistoryStore::Names() const {
+    std::lock_guard<std::mutex> guard(lock);
+    std::vector<std::string> names;
+    names.reserve(series.size());
+    for (const auto& s : series) names.push_back(s->name);
+    return names;
+}
+
+size_t HistoryStore::SeriesCount() const {
+    std::lock_guard<std::mutex> guard(lock);
+    return series.size();
+}
+
+size_t HistoryStore::Rejected() const {
+    std::lock_guard<std::mutex> guard(lock);
+    return rejected;
+}
+
+size_t HistoryStore::BytesUsed() const {
+    std::lock_guard<std::mutex> guard(lock);
+    return used;
+}
+
+size_t HistoryStore::SamplesStored() const {
+    std::lock_guard<std::mutex> guard(lock);
+    size_t n = 0;
+    for (const auto& s : series) {
+        for (size_t i = 0; i < s->raw.used; ++i) n += s->raw.Oldest(i).count;
+    }
+    return n;
+}
+
+size_t HistoryStore::CompressedBytes() const {
+    std::lock_guard<std::mutex> guard(lock);
+    size_t n = 0;
+    for (const auto& s : series) {
+        for (size_t i = 0; i < s->raw.used; ++i) n += (s->raw.Oldest(i).bits + 7) / 8;
+    }
+    return n;
+}
+
+void HistoryStore::Flush() {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        for (auto& s : series) {
+            Ring* rings[1 + kTiers] = {&s->raw, &s->tier[0], &s->tier[1], &s->tier[2], &s->tier[3]};
+            for (Ring* r : rings) {
+                if (!r->dirty) continue;
+                HistoryChunk& head = r->chunks[r->head];
+                head.checksum = ChunkChecksum(head);
+                r->dirty = false;
+            }
+        }
+    }
+    // Only schedules write-back of the dirty pages; the collector never waits on the disk
+    if (fd >= 0) msync(map, map_bytes, MS_ASYNC);
+}
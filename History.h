@@ -0,0 +1,181 @@
+#ifndef HISTORY_H
+#define HISTORY_H
+
+#include <vector>
+#include <string>
+#include <mutex>
+#include <memory>
+#include <cstdint>
+#include <climits>
+#include <unordered_map>
+#include "Gorilla.h"
+
+struct HistorySample {
+    int64_t t_ms;   // wall clock, ms since the epoch
+    float value;
+};
+
+// One rollup bucket, or one raw sample when count is 1 and min == max == avg
+struct HistoryBucket {
+    int64_t t_ms;   // start of the bucket
+    float min;
+    float max;
+    float avg;
+    uint32_t count; // raw samples folded in
+};
+
+// Fixed-memory time-series store. Each named series owns a ring of
+// Gorilla-compressed chunks (see Gorilla.h), carved out of one mapping sized
+// by the budget at construction. Appends are O(1) and never allocate: they
+// extend the newest chunk and, once it is full, recycle the oldest one.
+// Chunks are in time order (out-of-order appends are dropped), so Range()
+// binary-searches to the first chunk that reaches the start of the range and
+// decodes forward from there.
+//
+// Every series also keeps rollup tiers of 1 s, 10 s, 1 min and 10 min
+// buckets (min/max/avg/count, one 4-column chunk ring per tier), so long
+// spans are read at a resolution a graph can use. They are built as samples
+// arrive: a raw sample folds into the open 1 s bucket, and a bucket that
+// closes folds into the next tier's open one. Open buckets live only in
+// memory; on reopening they are replayed from the finer ring. Tier rings are
+// sized in proportion to the raw ring and together match it, so a series
+// costs twice its raw ring; a range that reaches past what a full ring still
+// holds is read from a coarser tier instead.
+//
+// With a path the mapping is a file of fixed size, so history survives a
+// restart: the file is mapped again and its series are usable at once.
+// Layout: a header, a directory of series (name and chunk range, written once
+// and sealed by a checksum), then the page-aligned chunk area. Each chunk
+// carries its position in its ring and a checksum, refreshed when it fills
+// and on Flush(); on open a series' ring is rebuilt backwards from its newest
+// chunk over consecutive, intact chunks, and the newest chunk - usually
+// written past its last checksum - is kept if it still decodes consistently.
+// All methods are thread-safe: the collector thread appends while the UI reads.
+class HistoryStore {
+public:
+    static constexpr size_t kDefaultBudget = 64u << 20;   // bytes of chunk storage: 2048 series of the default size
+    static constexpr size_t kDefaultChunks = 32;          // 16 KB raw: ~10 min at 100 ms for typical series
+    static constexpr size_t kMaxName = 47;
+    static constexpr int kNoSeries = -1;
+    static constexpr int kTiers = 4;
+    static constexpr int64_t kTierMs[kTiers] = {1000, 10000, 60000, 600000};
+    // Eighths of the raw ring per tier. ~35 buckets a chunk: with the default
+    // raw ring, about 2 min, 20 min, 4.5 h and 4 days
+    static constexpr size_t kTierEighths[kTiers] = {1, 1, 2, 4};
+
+    // Memory only when path is empty. A file that is missing, in use by
+    // another instance or laid out for a different budget is recreated, or
+    // (if that fails) the store falls back to memory and says why in Error().
+    explicit HistoryStore(size_t budget_bytes = kDefaultBudget, const std::string& path = std::string());
+    // Read-only view of an existing file, sized by its header: a private copy
+    // of the mapping, so nothing is written back and a running instance is
+    // not locked out. Empty, with Error() set, if the file is not usable.
+    static std::unique_ptr<HistoryStore> OpenReadOnly(const std::string& path);
+    ~HistoryStore();
+    HistoryStore(const HistoryStore&) = delete;
+    HistoryStore& operator=(const HistoryStore&) = delete;
+
+    // Id of the series, creating it if needed; kNoSeries once the budget is
+    // spent or for names over kMaxName. chunks sizes the raw ring; the tiers
+    // add as much again (kTierEighths), and the total is rounded up to whole
+    // pages. A series reopened from the file keeps its ring sizes.
+    int Register(const std::string& name, size_t chunks = kDefaultChunks);
+    int Find(const std::string& name) const;
+
+    void Append(int id, int64_t t_ms, float value); // no-op for kNoSeries
+    bool Latest(int id, HistorySample& out) const;
+    // Samples with from_ms <= t_ms <= to_ms, oldest first, into out (cleared first)
+    size_t Range(int id, int64_t from_ms, int64_t to_ms, std::vector<HistorySample>& out) const;
+    // Buckets covering [from_ms, to_ms] from the coarsest tier no wider than
+    // resolution_ms, or raw samples when that is finer than every tier; a
+    // coarser tier when that one has recycled data from after from_ms. The
+    // bucket still filling comes last. *width_ms gets the tier used (0: raw).
+    size_t Range(int id, int64_t from_ms, int64_t to_ms, int64_t resolution_ms, std::vector<HistoryBucket>& out,
+                 int64_t* width_ms = nullptr) const;
+    // Every bucket of tier k (see kTierMs), oldest first, then its open
+    // bucket; unlike Range() it never substitutes another tier
+    size_t Tier(int id, int k, std::vector<HistoryBucket>& out) const;
+
+    std::vector<std::string> Names() const; // indexed by id
+    size_t SeriesCount() const;
+    size_t Rejected() const;                // Register() calls refused: budget spent or name too long
+    size_t BytesUsed() const;
+    size_t Budget() const { return budget; }
+    size_t SamplesStored() const;           // raw samples
+    size_t CompressedBytes() const;         // raw bits actually written, rounded up per chunk
+
+    // Checksums the chunks written since the last call and asks the kernel to
+    // write the file back (MS_ASYNC: does not wait for the disk). Cheap enough
+    // to call every second from the collector thread.
+    void Flush();
+    bool Persistent() const { return fd >= 0; }
+    const std::string& Path() const { return path; }
+    const std::string& Error() const { return error; }
+    size_t Recovered() const { return recovered; }   // series reopened from the file
+
+private:
+    struct FileHeader;
+    struct DirEntry;
+
+    // One ring of chunks in the mapping; chunks[head] is being written
+    struct Ring {
+        HistoryChunk* chunks = nullptr;
+        size_t size = 0;
+        size_t head = 0;
+        size_t used = 0;                  // chunks holding data, ending at head
+        int columns = 1;
+        ChunkEncoder encoder;
+        bool dirty = false;               // head written since its checksum
+
+        const HistoryChunk& Oldest(size_t i) const { return chunks[(head + size + 1 - used + i) % size]; }
+    };
+
+    // Rollup bucket still filling
+    struct OpenBucket {
+        int64_t t_ms = 0;
+        float min = 0.0f;
+        float max = 0.0f;
+        double sum = 0.0;
+        uint32_t count = 0;
+    };
+
+    struct Series {
+        std::string name;
+        Ring raw;
+        HistorySample last = {INT64_MIN, 0.0f}; // INT64_MIN until the first sample
+        Ring tier[kTiers];                      // columns: min, max, avg, count
+        OpenBucket open[kTiers];
+        int64_t closed[kTiers] = {INT64_MIN, INT64_MIN, INT64_MIN, INT64_MIN}; // start of the newest bucket in the ring
+    };
+
+    static void Push(Ring& ring, int64_t t_ms, const float* values);
+    static void Fold(Series& s, int tier, int64_t t_ms, float min, float max, double sum, uint32_t count, bool cascade);
+    static bool OpenRing(Ring& ring, int64_t& last_t, float* last_values);
+    template <typename F> static void Scan(const Ring& ring, int64_t from_ms, int64_t to_ms, F each);
+
+    bool Map(size_t budget_bytes);
+    bool MapReadOnly();
+    void Recover();
+    void Open(Series& s);
+    void Layout(Series& s, size_t first, const uint32_t* sizes);
+
+    mutable std::mutex lock;
+    std::vector<std::unique_ptr<Series>> series; // ids index here and are never reused
+    std::unordered_map<std::string, int> index;
+    size_t budget = 0;
+    size_t used = 0;
+    size_t rejected = 0;
+
+    std::string path;
+    std::string error;
+    int fd = -1;               // the history file, -1 when memory only
+    uint8_t* map = nullptr;
+    size_t map_bytes = 0;
+    FileHeader* header = nullptr;
+    DirEntry* directory = nullptr;
+    HistoryChunk* area = nullptr;
+    size_t next_chunk = 0;     // first chunk of the area not owned by a series
+    size_t recovered = 0;
+};
+
+#endif
@@ -0,0 +1,166 @@
+#include "Interrupts.h"
+#include "Parser.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstring>
+
+// --- MATRIX COLUMN SCANNER ---
+// /proc/interrupts is one right-aligned column per CPU, padded to the widest
+// count. On a 256-CPU host a row is several KB, mostly spaces and long digit
+// runs, so both are consumed 8 bytes at a time (SWAR) where the target allows.
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define IRQ_SWAR 1
+#endif
+
+static inline const char* SkipSpaces(const char* p, const char* end) {
+#ifdef IRQ_SWAR
+    while (end - p >= 8) {
+        uint64_t w;
+        memcpy(&w, p, 8);
+        uint64_t x = w ^ 0x2020202020202020ULL; // zero bytes where there were spaces
+        if (x != 0) return p + __builtin_ctzll(x) / 8;
+        p += 8;
+    }
+#endif
+    while (p < end && *p == ' ') ++p;
+    return p;
+}
+
+#ifdef IRQ_SWAR
+static inline bool EightDigits(uint64_t w) {
+    return ((w & 0xF0F0F0F0F0F0F0F0ULL) == 0x3030303030303030ULL) &&
+           (((w + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) == 0x3030303030303030ULL);
+}
+
+static inline uint64_t ParseEight(uint64_t w) {
+    w -= 0x3030303030303030ULL;
+    w = (w * 10) + (w >> 8);
+    w = (((w & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32))) +
+         (((w >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32)))) >> 32;
+    return w;
+}
+#endif
+
+// Parses an unsigned decimal at p; returns p unchanged if there is no digit.
+static inline const char* ParseCount(const char* p, const char* end, uint64_t& out) {
+    uint64_t v = 0;
+#ifdef IRQ_SWAR
+    while (end - p >= 8) {
+        uint64_t w;
+        memcpy(&w, p, 8);
+        if (!EightDigits(w)) break;
+        v = v * 100000000ULL + ParseEight(w);
+        p += 8;
+    }
+#endif
+    while (p < end && (unsigned)(*p - '0') < 10) v = v * 10 + (*p++ - '0');
+    out = v;
+    return p;
+}
+
+static const char* LineEnd(const char* p, const char* end) {
+    const char* nl = (const char*)memchr(p, '\n', end - p);
+    return nl ? nl : end;
+}
+
+// Assigns only when the text changed, so unchanged labels never reallocate
+static bool Assign(std::string& dst, const char* p, size_t len) {
+    if (dst.size() == len && dst.compare(0, len, p, len) == 0) return false;
+    dst.assign(p, len);
+    return true;
+}
+
+InterruptCollector::InterruptCollector() {
+    irq.fd = open("/proc/interrupts", O_RDONLY | O_CLOEXEC);
+    softirq.fd = open("/proc/softirqs", O_RDONLY | O_CLOEXEC);
+}
+
+InterruptCollector::~InterruptCollector() {
+    if (irq.fd >= 0) close(irq.fd);
+    if (softirq.fd >= 0) close(softirq.fd);
+}
+
+void InterruptCollector::Sample(Source& src, IrqMatrix& out) {
+    size_t len = Parser::ReadWhole(src.fd, src.buf);
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if (len == 0) return;
+    const char* p = src.buf.data();
+    const char* end = p + len;
+
+    // Header: "           CPU0       CPU1 ..."
+    const char* eol = LineEnd(p, end);
+    size_t ncpu = 0;
+    bool layout_changed = false;
+    for (const char* h = p; h < eol;) {
+        h = SkipSpaces(h, eol);
+        if (eol - h < 4 || strncmp(h, "CPU", 3) != 0) break;
+        uint64_t id;
+        h = ParseCount(h + 3, eol, id);
+        if (ncpu >= out.cpus.size()) { out.cpus.push_back((int)id); layout_changed = true; }
+        else if (out.cpus[ncpu] != (int)id) { out.cpus[ncpu] = (int)id; layout_changed = true; }
+        ncpu++;
+    }
+    if (out.cpus.size() != ncpu) { out.cpus.resize(ncpu); layout_changed = true; }
+    p = eol + 1;
+
+    // Rows: "  24:    12    0  IO-APIC 5-edge ACPI:Ged"
+    size_t rows = 0;
+    while (p < end) {
+        eol = LineEnd(p, end);
+        const char* label = SkipSpaces(p, eol);
+        const char* colon = (const char*)memchr(label, ':', eol - label);
+        if (!colon) { p = eol + 1; continue; }
+
+        if (rows >= out.names.size()) {
+            out.names.emplace_back();
+            out.descriptions.emplace_back();
+            layout_changed = true;
+        }
+        if (Assign(out.names[rows], label, colon - label)) layout_changed = true;
+
+        if (src.counts.size() < (rows + 1) * ncpu) src.counts.resize((rows + 1) * ncpu);
+        uint64_t* row = src.counts.data() + rows * ncpu;
+        const char* q = colon + 1;
+        size_t col = 0;
+        // ERR/MIS and friends carry a single total instead of one column per CPU
+        for (; col < ncpu; ++col) {
+            const char* v = SkipSpaces(q, eol);
+            const char* after = ParseCount(v, eol, row[col]);
+            if (after == v) break;
+            q = after;
+        }
+        for (; col < ncpu; ++col) row[col] = 0;
+
+        const char* desc = SkipSpaces(q, eol);
+        Assign(out.descriptions[rows], desc, eol - desc);
+
+        rows++;
+        p = eol + 1;
+    }
+    if (out.names.size() != rows) {
+        out.names.resize(rows);
+        out.descriptions.resize(rows);
+        layout_changed = true;
+    }
+
+    // Per-interval deltas over the measured elapsed time
+    size_t cells = rows * ncpu;
+    out.rates.assign(cells, 0.0f);
+    if (src.has_last && !layout_changed && src.last.size() >= cells) {
+        float dt = std::chrono::duration<float>(now - src.last_time).count();
+        if (dt > 0.0f) {
+            for (size_t i = 0; i < cells; ++i) {
+                if (src.counts[i] >= src.last[i]) out.rates[i] = (src.counts[i] - src.last[i]) / dt;
+            }
+        }
+    }
+    src.last.assign(src.counts.begin(), src.counts.begin() + cells);
+    src.last_time = now;
+    src.has_last = true;
+}
+
+void InterruptCollector::Collect(IrqMatrix& hard, IrqMatrix& soft) {
+    Sample(irq, hard);
+    Sample(softirq, soft);
+}
@@ -0,0 +1,45 @@
+#ifndef INTERRUPTS_H
+#define INTERRUPTS_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <chrono>
+
+// One of /proc/interrupts or /proc/softirqs as a rows x cpus matrix of per-second rates.
+struct IrqMatrix {
+    std::vector<int> cpus;                 // CPU ids from the header (offline CPUs are absent)
+    std::vector<std::string> names;        // "24", "NMI", "NET_RX", ...
+    std::vector<std::string> descriptions; // "IO-APIC 5-edge ACPI:Ged" (empty for softirqs)
+    std::vector<float> rates;              // row-major, names.size() * cpus.size()
+
+    float Rate(size_t row, size_t cpu) const { return rates[row * cpus.size() + cpu]; }
+};
+
+class InterruptCollector {
+public:
+    InterruptCollector();
+    ~InterruptCollector();
+    InterruptCollector(const InterruptCollector&) = delete;
+    InterruptCollector& operator=(const InterruptCollector&) = delete;
+
+    void Collect(IrqMatrix& hard, IrqMatrix& soft);
+
+private:
+    // Per-file parse state; buffers are reused so steady-state sampling does not allocate
+    struct Source {
+        int fd = -1;
+        std::vector<char> buf;
+        std::vector<uint64_t> counts;
+        std::vector<uint64_t> last;
+        std::chrono::steady_clock::time_point last_time;
+        bool has_last = false;
+    };
+
+    void Sample(Source& src, IrqMatrix& out);
+
+    Source irq;
+    Source softirq;
+};
+
+#endif
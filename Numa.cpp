@@ -0,0 +1,145 @@
+#include "Numa.h"
+#include "Parser.h"
+#include <fstream>
+#include <sstream>
+#include <dirent.h>
+#include <cstdlib>
+#include <cstring>
+#include <cctype>
+#include <algorithm>
+
+static const char* kNodeDir = "/sys/devices/system/node";
+
+std::vector<int> NumaCollector::NodeIds() {
+    std::vector<int> ids;
+    DIR* dir = opendir(kNodeDir);
+    if (!dir) return ids; // kernel without NUMA support
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != nullptr) {
+        if (strncmp(entry->d_name, "node", 4) != 0 || !isdigit((unsigned char)entry->d_name[4])) continue;
+        ids.push_back(atoi(entry->d_name + 4));
+    }
+    closedir(dir);
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
+int NumaCollector::NodeOfCpu(int cpu) {
+    if (cpu_node.empty()) {
+        for (int node : NodeIds()) {
+            std::ifstream file(std::string(kNodeDir) + "/node" + std::to_string(node) + "/cpulist");
+            std::string list;
+            std::getline(file, list);
+            for (int c : Parser::CpuList(list)) cpu_node[c] = node;
+        }
+    }
+    auto it = cpu_node.find(cpu);
+    return it == cpu_node.end() ? -1 : it->second;
+}
+
+std::vector<NumaNode> NumaCollector::Collect() {
+    std::vector<NumaNode> nodes;
+    std::unordered_map<int, Counters> now;
+    std::chrono::steady_clock::time_point t = std::chrono::steady_clock::now();
+    float dt = std::chrono::duration<float>(t - last_time).count();
+
+    for (int id : NodeIds()) {
+        std::string base = std::string(kNodeDir) + "/node" + std::to_string(id);
+        NumaNode node;
+        memset(&node, 0, sizeof(node));
+        node.id = id;
+
+        // "Node 0 MemTotal:        4816632 kB"
+        std::ifstream meminfo(base + "/meminfo");
+        std::string line;
+        while (std::getline(meminfo, line)) {
+            std::istringstream ss(line);
+            std::string word, key;
+            int node_id;
+            long value;
+            if (!(ss >> word >> node_id >> key >> value)) continue;
+            if (key == "MemTotal:") node.total_kb = value;
+            else if (key == "MemFree:") node.free_kb = value;
+            else if (key == "FilePages:") node.file_kb = value;
+            else if (key == "AnonPages:") node.anon_kb = value;
+        }
+        if (node.total_kb > 0) node.percent_used = 100.0f * (node.total_kb - node.free_kb) / node.total_kb;
+
+        Counters c = {};
+        std::ifstream numastat(base + "/numastat");
+        std::string key;
+        unsigned long long value;
+        while (numastat >> key >> value) {
+            if (key == "numa_hit") c.hit = value;
+            else if (key == "numa_miss") c.miss = value;
+            else if (key == "numa_foreign") c.foreign = value;
+            else if (key == "local_node") c.local = value;
+            else if (key == "other_node") c.other = value;
+            else if (key == "interleave_hit") c.interleave = value;
+        }
+        now[id] = c;
+
+        auto prev = last.find(id);
+        if (prev != last.end() && dt > 0.0f) {
+            const Counters& p = prev->second;
+            auto rate = [&](unsigned long long cur, unsigned long long old) {
+                return cur >= old ? (float)(cur - old) / dt : 0.0f;
+            };
+            node.hit = rate(c.hit, p.hit);
+            node.miss = rate(c.miss, p.miss);
+            node.foreign = rate(c.foreign, p.foreign);
+            node.local = rate(c.local, p.local);
+            node.other = rate(c.other, p.other);
+            node.interleave = rate(c.interleave, p.interleave);
+        }
+        float allocs = node.local + node.other;
+        node.local_percent = allocs > 0.0f ? 100.0f * node.local / allocs : 100.0f;
+        nodes.push_back(node);
+    }
+
+    last.swap(now);
+    last_time = t;
+    return nodes;
+}
+
+NumaProcess NumaCollector::CollectProcess(int pid) {
+    NumaProcess proc;
+    proc.pid = pid;
+
+    Parser::ProcStat stat;
+    if (Parser::ProcessStat(pid, stat) && stat.processor >= 0) proc.home_node = NodeOfCpu(stat.processor);
+
+    // "7f3a... default file=/usr/lib/libc.so.6 mapped=120 N0=100 N1=20 kernelpagesize_kB=4"
+    std::unordered_map<int, long> kb;
+    std::ifstream file("/proc/" + std::to_string(pid) + "/numa_maps");
+    std::string line;
+    std::vector<std::pair<int, long>> pages;
+    while (std::getline(file, line)) {
+        std::istringstream ss(line);
+        std::string token;
+        long page_kb = 4;
+        pages.clear();
+        while (ss >> token) {
+            if (token.size() > 2 && token[0] == 'N' && isdigit((unsigned char)token[1])) {
+                size_t eq = token.find('=');
+                if (eq == std::string::npos) continue;
+                pages.push_back({atoi(token.c_str() + 1), atol(token.c_str() + eq + 1)});
+            } else if (token.compare(0, 18, "kernelpagesize_kB=") == 0) {
+                page_kb = atol(token.c_str() + 18);
+            }
+        }
+        // The page size comes last on the line, so scale once it is known
+        for (const auto& p : pages) kb[p.first] += p.second * page_kb;
+    }
+
+    for (const auto& kv : kb) proc.node_ids.push_back(kv.first);
+    std::sort(proc.node_ids.begin(), proc.node_ids.end());
+    for (int id : proc.node_ids) {
+        proc.node_kb.push_back(kb[id]);
+        proc.total_kb += kb[id];
+    }
+    if (proc.total_kb > 0 && proc.home_node >= 0) {
+        proc.local_percent = 100.0f * kb[proc.home_node] / proc.total_kb;
+    }
+    return proc;
+}
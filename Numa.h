@@ -0,0 +1,55 @@
+#ifndef NUMA_H
+#define NUMA_H
+
+#include <vector>
+#include <string>
+#include <chrono>
+#include <unordered_map>
+
+struct NumaNode {
+    int id;
+    long total_kb;
+    long free_kb;
+    long file_kb;
+    long anon_kb;
+    float percent_used;
+
+    // numastat counters as pages/s over the measured interval
+    float hit;           // allocated here as intended
+    float miss;          // intended elsewhere, allocated here
+    float foreign;       // intended here, allocated elsewhere
+    float local;         // allocated here by a task running on this node
+    float other;         // allocated here by a task running on another node
+    float interleave;
+    float local_percent; // local / (local + other); 100 when idle
+};
+
+// Where one process's resident pages live (from /proc/PID/numa_maps)
+struct NumaProcess {
+    int pid = -1;
+    int home_node = -1;                 // node of the CPU it last ran on, -1 if unknown
+    std::vector<int> node_ids;
+    std::vector<long> node_kb;          // parallel to node_ids
+    long total_kb = 0;
+    float local_percent = 0.0f;         // share of pages on home_node
+};
+
+class NumaCollector {
+public:
+    std::vector<NumaNode> Collect();
+    NumaProcess CollectProcess(int pid);
+
+private:
+    struct Counters {
+        unsigned long long hit, miss, foreign, local, other, interleave;
+    };
+
+    std::vector<int> NodeIds();
+    int NodeOfCpu(int cpu);
+
+    std::unordered_map<int, Counters> last;
+    std::chrono::steady_clock::time_point last_time;
+    std::unordered_map<int, int> cpu_node; // cpu -> node, from nodeN/cpulist
+};
+
+#endif
@@ -0,0 +1,129 @@
+#include "Overhead.h"
+#include "Parser.h"
+#include <new>
+#include <atomic>
+#include <string>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+// --- COUNTING ALLOCATOR ---
+// Replaces the global operator new/delete for the whole binary. The per-thread
+// count is a plain thread_local, so the collector thread can attribute
+// allocations to the collector that made them; the totals are relaxed atomics.
+static std::atomic<uint64_t> total_allocs{0};
+static std::atomic<uint64_t> total_alloc_bytes{0};
+static thread_local uint64_t thread_allocs = 0;
+
+void* operator new(std::size_t size) {
+    thread_allocs++;
+    total_allocs.fetch_add(1, std::memory_order_relaxed);
+    total_alloc_bytes.fetch_add(size, std::memory_order_relaxed);
+    if (size == 0) size = 1;
+    while (true) {
+        void* p = malloc(size);
+        if (p) return p;
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) throw std::bad_alloc();
+        handler();
+    }
+}
+
+void* operator new[](std::size_t size) { return ::operator new(size); }
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, std::size_t) noexcept { free(p); }
+void operator delete[](void* p, std::size_t) noexcept { free(p); }
+
+uint64_t Overhead::ThreadAllocations() { return thread_allocs; }
+uint64_t Overhead::TotalAllocations() { return total_allocs.load(std::memory_order_relaxed); }
+uint64_t Overhead::TotalAllocatedBytes() { return total_alloc_bytes.load(std::memory_order_relaxed); }
+
+static double ClockSeconds(clockid_t clock) {
+    timespec ts;
+    clock_gettime(clock, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+double Overhead::ThreadCpuSeconds() { return ClockSeconds(CLOCK_THREAD_CPUTIME_ID); }
+double Overhead::ProcessCpuSeconds() { return ClockSeconds(CLOCK_PROCESS_CPUTIME_ID); }
+
+long Overhead::RssKb() {
+    // "size resident shared ..." in pages; read without allocating
+    int fd = open("/proc/self/statm", O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return 0;
+    char text[128];
+    ssize_t n = read(fd, text, sizeof(text) - 1);
+    close(fd);
+    if (n <= 0) return 0;
+    text[n] = '\0';
+    char* p = strchr(text, ' ');
+    if (!p) return 0;
+    return strtol(p + 1, nullptr, 10) * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+// --- I/O COUNTERS ---
+IoMonitor::~IoMonitor() {
+    if (fd >= 0) close(fd);
+}
+
+IoCounters IoMonitor::Read() {
+    IoCounters out;
+    if (fd < 0) {
+        std::string path = whole_process ? "/proc/self/io"
+                                         : "/proc/self/task/" + std::to_string((long)syscall(SYS_gettid)) + "/io";
+        fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return out;
+    }
+    size_t len = Parser::ReadWhole(fd, buf);
+    if (len == 0) return out;
+
+    // "rchar: N\nwchar: N\nsyscr: N\n..."
+    const char* text = buf.data();
+    const char* end = text + len;
+    uint64_t rchar = 0, syscr = 0;
+    for (const char* line = text; line < end;) {
+        const char* nl = (const char*)memchr(line, '\n', end - line);
+        if (!nl) nl = end;
+        if (nl - line > 7 && memcmp(line, "rchar: ", 7) == 0) rchar = strtoull(line + 7, nullptr, 10);
+        else if (nl - line > 7 && memcmp(line, "syscr: ", 7) == 0) syscr = strtoull(line + 7, nullptr, 10);
+        line = nl + 1;
+    }
+
+    // The values already include every earlier Read() but not this one
+    out.syscalls = syscr - own.syscalls;
+    out.bytes = rchar - own.bytes;
+    own.syscalls += 2; // ReadWhole: the data, then the end-of-file pread
+    own.bytes += len;
+    return out;
+}
+
+// --- PROCESS-WIDE ---
+SelfUsage OverheadMonitor::Collect() {
+    SelfUsage usage;
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    double cpu = Overhead::ProcessCpuSeconds();
+    uint64_t allocs = Overhead::TotalAllocations();
+    uint64_t alloc_bytes = Overhead::TotalAllocatedBytes();
+    IoCounters counters = io.Read();
+    usage.rss_kb = Overhead::RssKb();
+
+    bool first = last_time.time_since_epoch().count() == 0;
+    float dt = std::chrono::duration<float>(now - last_time).count();
+    if (!first && dt > 0.0f) {
+        usage.cpu_percent = (float)(100.0 * (cpu - last_cpu) / dt);
+        usage.allocs_per_sec = (allocs - last_allocs) / dt;
+        usage.alloc_kb_per_sec = (alloc_bytes - last_alloc_bytes) / 1024.0f / dt;
+        usage.read_syscalls_per_sec = (counters.syscalls - last_io.syscalls) / dt;
+        usage.read_kb_per_sec = (counters.bytes - last_io.bytes) / 1024.0f / dt;
+    }
+    last_time = now;
+    last_cpu = cpu;
+    last_allocs = allocs;
+    last_alloc_bytes = alloc_bytes;
+    last_io = counters;
+    return usage;
+}
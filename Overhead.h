@@ -0,0 +1,70 @@
+#ifndef OVERHEAD_H
+#define OVERHEAD_H
+
+#include <vector>
+#include <cstdint>
+#include <chrono>
+
+// What the monitor itself costs. Rates are per second over the measured
+// interval between two samples.
+struct SelfUsage {
+    float cpu_percent = 0.0f;          // whole process, of one core
+    long rss_kb = 0;
+    float allocs_per_sec = 0.0f;       // operator new calls, all threads
+    float alloc_kb_per_sec = 0.0f;
+    float read_syscalls_per_sec = 0.0f; // read-type syscalls, all threads (/proc/self/io syscr)
+    float read_kb_per_sec = 0.0f;      // bytes read, including /proc and /sys (rchar)
+};
+
+// Read-side I/O counters of a task, net of the reads used to measure them
+struct IoCounters {
+    uint64_t syscalls = 0;
+    uint64_t bytes = 0;
+};
+
+namespace Overhead {
+    // Counted by the global operator new replacement in Overhead.cpp
+    uint64_t ThreadAllocations();   // calls made by the calling thread
+    uint64_t TotalAllocations();    // by all threads
+    uint64_t TotalAllocatedBytes();
+
+    double ThreadCpuSeconds();      // CLOCK_THREAD_CPUTIME_ID
+    double ProcessCpuSeconds();     // CLOCK_PROCESS_CPUTIME_ID
+    long RssKb();
+}
+
+// /proc/self/task/TID/io (or /proc/self/io) through a persistent fd. The
+// thread file is bound to whichever thread opens it, which is the first
+// caller of Read().
+class IoMonitor {
+public:
+    explicit IoMonitor(bool whole_process) : whole_process(whole_process) {}
+    ~IoMonitor();
+    IoMonitor(const IoMonitor&) = delete;
+    IoMonitor& operator=(const IoMonitor&) = delete;
+
+    IoCounters Read();
+
+private:
+    bool whole_process;
+    int fd = -1;
+    std::vector<char> buf;
+    IoCounters own; // cost of our own reads so far
+};
+
+// Process-wide numbers for the self-overhead panel
+class OverheadMonitor {
+public:
+    OverheadMonitor() : io(true) {}
+    SelfUsage Collect();
+
+private:
+    IoMonitor io;
+    std::chrono::steady_clock::time_point last_time;
+    double last_cpu = 0.0;
+    uint64_t last_allocs = 0;
+    uint64_t last_alloc_bytes = 0;
+    IoCounters last_io;
+};
+
+#endif
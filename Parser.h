@@ -3,6 +3,7 @@
 
 #include <vector>
 #include <string>
+#include <memory_resource>
 
 namespace Parser {
     struct NetStats {
@@ -10,6 +11,12 @@ namespace Parser {
         long tx_bytes;
     };
 
+    // Aggregate "cpu" line of /proc/stat (clock ticks since boot)
+    struct CpuTimes {
+        long long busy;
+        long long total;
+    };
+
     struct DiskStats {
         std::string name;
         long total_bytes;
@@ -17,16 +24,41 @@ namespace Parser {
         float percent_used;
     };
 
-    float CpuUsage();
+    // Fields of /proc/PID/stat we care about (clock ticks)
+    struct ProcStat {
+        char state;          // R, S, D, Z, ...
+        int ppid;
+        long utime;
+        long stime;
+        long cutime;
+        long cstime;
+        long long starttime;
+        int processor;       // CPU it last ran on, -1 if not reported
+        std::string comm;    // executable name; changes on exec
+    };
+
+    // pread()s a whole /proc file from offset 0 into buf (grown as needed); returns bytes read, 0 on error
+    size_t ReadWhole(int fd, std::vector<char>& buf);
+    // One read() of at most size - 1 bytes, NUL-terminated; for files whose fields sit near the top
+    size_t ReadFile(const char* path, char* buf, size_t size);
+
+    // The readers below do not touch the heap unless given a scratch resource that does
+    CpuTimes GetCpuTimes();
     float MemoryUsage();
-    NetStats GetNetworkTraffic();
+    NetStats GetNetworkTraffic(std::pmr::memory_resource* scratch = std::pmr::get_default_resource());
     bool IsConnected(); // <--- NEW CHECK
     int GetBatteryPercentage();
     std::vector<DiskStats> GetDiskUsage();
     std::vector<int> Pids();
-    float ProcessCpuUsage(int pid);
+    std::pmr::vector<int> Pids(std::pmr::memory_resource* scratch);
+    bool ProcessStat(int pid, ProcStat& out);
+    bool ParseProcessStat(const char* text, size_t len, ProcStat& out); // contents of /proc/PID/stat
+    float ProcessCpuUsage(int pid);               // average over the process lifetime
+    float ProcessCpuUsage(const ProcStat& stat);
     float ProcessMemoryUsage(int pid);
     std::string Command(int pid);
+    long OpenFileLimit(int pid); // soft RLIMIT_NOFILE, -1 if unlimited/unreadable
+    std::vector<int> CpuList(const std::string& list); // "0-15,32-47" -> cpu numbers; empty if malformed
 }
 
 #endif
\ No newline at end of file
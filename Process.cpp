@@ -1,12 +1,53 @@
 #include "Process.h"
 #include "Parser.h"
+#include <unistd.h>
+
+static const float kClockTicks = (float)sysconf(_SC_CLK_TCK);
 
 Process::Process(int pid) : pid(pid) {
     Update();
 }
 
-void Process::Update() {
-    cpuUsage = Parser::ProcessCpuUsage(pid);
+Process::Process(int pid, const Parser::ProcStat* stat) : pid(pid) {
+    Update(stat);
+}
+
+bool Process::Update() {
+    Parser::ProcStat stat;
+    return Update(Parser::ProcessStat(pid, stat) ? &stat : nullptr);
+}
+
+bool Process::Update(const Parser::ProcStat* read) {
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if (!read) {
+        cpuUsage = 0.0f;
+        sampled_at = now;
+        return false;
+    }
+    const Parser::ProcStat& stat = *read;
+
+    // A new process behind this pid has no baseline; an exec keeps the
+    // baseline but means argv has to be read again
+    bool fresh = command.empty() || stat.starttime != starttime;
+    bool exec = !fresh && stat.comm != comm;
+    long ticks = stat.utime + stat.stime;
+    float seconds = std::chrono::duration<float>(now - sampled_at).count();
+    if (fresh || seconds <= 0.0f) cpuUsage = 0.0f;
+    else cpuUsage = 100.0f * (ticks - cpu_ticks) / kClockTicks / seconds;
+
+    bool active = fresh || exec || ticks != cpu_ticks;
+    starttime = stat.starttime;
+    cpu_ticks = ticks;
+    ppid = stat.ppid;
+    state = stat.state;
+    sampled_at = now;
+    if (fresh || exec) comm = stat.comm;
+    if (!active) return false; // nothing ran, so RSS and the rest are as we left them
+
     memoryUsage = Parser::ProcessMemoryUsage(pid);
-    command = Parser::Command(pid);
+    if (fresh || exec) {
+        command = Parser::Command(pid);
+        command_version++;
+    }
+    return true;
 }
@@ -2,18 +2,35 @@
 #define PROCESS_H
 
 #include <string>
+#include <chrono>
+#include <cstdint>
+#include "Parser.h"
 
 class Process {
 public:
     Process(int pid);
+    Process(int pid, const Parser::ProcStat* stat); // stat already read, see Update(stat)
 
     int pid;
-    float cpuUsage;
-    float memoryUsage;
+    float cpuUsage = 0.0f;    // percent of one CPU between the last two reads
+    float memoryUsage = 0.0f;
+    long long starttime = 0; // clock ticks after boot; (pid, starttime) identifies a process across pid reuse
+    long cpu_ticks = 0;      // utime + stime
+    int ppid = 0;
+    char state = '?';
     std::string command;
+    uint32_t command_version = 0; // bumped whenever command is re-read
+    std::chrono::steady_clock::time_point sampled_at; // when the fields above were last confirmed
+
+    // Reads stat, and status/cmdline only when needed: status when the process
+    // used CPU since the last call, cmdline once per (pid, starttime) and exec.
+    // Returns true if the process was active since the previous call.
+    bool Update();
+    // Same, from a /proc/PID/stat the caller read (nullptr: it was unreadable)
+    bool Update(const Parser::ProcStat* stat);
 
 private:
-    void Update();
+    std::string comm; // from stat, to notice exec without rereading cmdline
 };
 
 #endif
@@ -0,0 +1,161 @@
+#include "ProcessHistory.h"
+
+ProcessHistory::ProcessHistory(size_t budget_bytes, int64_t grace_ms) : grace_ms(grace_ms) {
+    pool.resize(budget_bytes / sizeof(HistoryChunk));
+    free_chunks.reserve(pool.size());
+    for (size_t i = pool.size(); i-- > 0;) free_chunks.push_back((uint32_t)i);
+}
+
+// --- UPDATE ---
+void ProcessHistory::Update(const ProcessTable& table, std::chrono::steady_clock::time_point steady_now, int64_t now_ms) {
+    std::lock_guard<std::mutex> guard(lock);
+    generation++;
+    for (size_t row = 0; row < table.Size(); ++row) {
+        ProcessKey key = {table.pid[row], table.starttime[row]};
+        auto it = index.find(key);
+        size_t slot;
+        if (it != index.end()) {
+            slot = it->second;
+        } else {
+            if (free_slots.empty()) {
+                slot = series.size();
+                series.emplace_back();
+            } else {
+                slot = free_slots.back();
+                free_slots.pop_back();
+                series[slot] = Series();
+            }
+            series[slot].key = key;
+            series[slot].alive = true;
+            series[slot].in_use = true;
+            index.emplace(key, slot);
+        }
+
+        Series& s = series[slot];
+        s.seen = generation;
+        if (!s.alive) {
+            // Missing from one table only (a bounded sweep can lag); not dead after all
+            dead.erase({s.viewed_ms, slot});
+            s.alive = true;
+        }
+        int64_t t = now_ms - std::chrono::duration_cast<std::chrono::milliseconds>(steady_now - table.sampled_at[row]).count();
+        if (t <= s.last_t) continue; // not re-read since the last update
+        float values[2] = {table.cpu[row], table.rss_mb[row]};
+        if (s.used == 0 || !s.encoder.Append(t, values)) {
+            if (!Grow(s)) continue;
+            s.encoder.Append(t, values);
+        }
+        s.last_t = t;
+    }
+
+    for (size_t slot = 0; slot < series.size(); ++slot) {
+        Series& s = series[slot];
+        if (!s.in_use) continue;
+        if (s.alive && s.seen != generation) {
+            s.alive = false;
+            s.died_ms = now_ms;
+            dead.insert({s.viewed_ms, slot});
+        } else if (!s.alive && now_ms - s.died_ms > grace_ms) {
+            Release(slot);
+        }
+    }
+}
+
+// Starts a new chunk at the head of s; false if none could be found
+bool ProcessHistory::Grow(Series& s) {
+    uint32_t chunk = 0;
+    bool recycle = s.used == kMaxChunks;
+    if (!recycle && !TakeChunk(chunk, s)) {
+        if (s.used == 0) return false;
+        recycle = true;
+    }
+    if (recycle) {
+        chunk = s.Oldest(0);
+        s.used--;
+    }
+    s.head = s.used == 0 ? 0 : (s.head + 1) % kMaxChunks;
+    s.chunks[s.head] = chunk;
+    s.used++;
+    s.encoder.Start(pool[chunk], 2);
+    return true;
+}
+
+bool ProcessHistory::TakeChunk(uint32_t& chunk, const Series& requester) {
+    if (free_chunks.empty() && !dead.empty()) {
+        Release(dead.begin()->second);
+        evictions++;
+    }
+    if (free_chunks.empty()) {
+        // No dead series left: the live series with the most chunks gives up its oldest
+        Series* victim = nullptr;
+        for (Series& s : series) {
+            if (s.in_use && &s != &requester && s.used >= 2 && (!victim || s.used > victim->used)) victim = &s;
+        }
+        if (!victim) return false;
+        free_chunks.push_back(victim->Oldest(0));
+        victim->used--;
+    }
+    chunk = free_chunks.back();
+    free_chunks.pop_back();
+    return true;
+}
+
+void ProcessHistory::Release(size_t slot) {
+    Series& s = series[slot];
+    for (size_t i = 0; i < s.used; ++i) free_chunks.push_back(s.Oldest(i));
+    if (!s.alive) dead.erase({s.viewed_ms, slot});
+    index.erase(s.key);
+    s.used = 0;
+    s.in_use = false;
+    free_slots.push_back(slot);
+}
+
+// --- QUERIES ---
+bool ProcessHistory::Range(int pid, long long starttime, int64_t from_ms, int64_t to_ms, std::vector<ProcessSample>& out) {
+    out.clear();
+    int64_t now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    std::lock_guard<std::mutex> guard(lock);
+    auto it = index.find({pid, starttime});
+    if (it == index.end()) return false;
+    size_t slot = it->second;
+    Series& s = series[slot];
+    if (!s.alive) {
+        dead.erase({s.viewed_ms, slot});
+        dead.insert({now_ms, slot});
+    }
+    s.viewed_ms = now_ms;
+
+    for (size_t i = 0; i < s.used; ++i) {
+        const HistoryChunk& c = pool[s.Oldest(i)];
+        if (c.count == 0 || c.last_t < from_ms) continue;
+        if (c.first_t > to_ms) break;
+        ChunkDecoder decoder(c, 2);
+        int64_t t;
+        float values[2];
+        while (decoder.Next(t, values)) {
+            if (t > to_ms) break;
+            if (t >= from_ms) out.push_back({t, values[0], values[1]});
+        }
+    }
+    return true;
+}
+
+size_t ProcessHistory::SeriesCount() const {
+    std::lock_guard<std::mutex> guard(lock);
+    return index.size();
+}
+
+size_t ProcessHistory::DeadCount() const {
+    std::lock_guard<std::mutex> guard(lock);
+    return dead.size();
+}
+
+size_t ProcessHistory::ChunksUsed() const {
+    std::lock_guard<std::mutex> guard(lock);
+    return pool.size() - free_chunks.size();
+}
+
+size_t ProcessHistory::Evictions() const {
+    std::lock_guard<std::mutex> guard(lock);
+    return evictions;
+}
@@ -0,0 +1,88 @@
+#ifndef PROCESSHISTORY_H
+#define PROCESSHISTORY_H
+
+#include <set>
+#include <mutex>
+#include <chrono>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+#include "Gorilla.h"
+#include "ProcessTable.h"
+
+struct ProcessSample {
+    int64_t t_ms;   // wall clock, ms since the epoch
+    float cpu;      // percent of one CPU
+    float rss_mb;
+};
+
+// CPU and RSS history per process, keyed by (pid, starttime) so a reused pid
+// starts a new series. Samples are (cpu, rss) pairs in 2-column Gorilla
+// chunks drawn from one pool fixed at construction; a series holds at most
+// kMaxChunks of them and recycles its oldest after that. A process that
+// leaves the table is kept for the grace period so it can still be looked
+// at. When the pool runs dry, dead series are evicted least recently viewed
+// first (ones never viewed go first); with no dead series left, the live
+// series holding the most chunks gives up its oldest one.
+// All methods are thread-safe: the collector thread updates while the UI reads.
+class ProcessHistory {
+public:
+    static constexpr size_t kDefaultBudget = 4u << 20;   // bytes of chunk pool
+    static constexpr int64_t kDefaultGraceMs = 300000;
+    static constexpr size_t kMaxChunks = 8;              // ~10 min at 1 s per process
+
+    explicit ProcessHistory(size_t budget_bytes = kDefaultBudget, int64_t grace_ms = kDefaultGraceMs);
+    ProcessHistory(const ProcessHistory&) = delete;
+    ProcessHistory& operator=(const ProcessHistory&) = delete;
+
+    // Appends every row sampled since its last update and retires processes
+    // that left the table. steady_now and now_ms are the same instant, to
+    // place the rows' steady_clock sample times on the wall clock.
+    void Update(const ProcessTable& table, std::chrono::steady_clock::time_point steady_now, int64_t now_ms);
+
+    // Samples with from_ms <= t_ms <= to_ms, oldest first, into out (cleared
+    // first). Counts as a view for eviction order. False if the process has
+    // no series (never seen, or evicted).
+    bool Range(int pid, long long starttime, int64_t from_ms, int64_t to_ms, std::vector<ProcessSample>& out);
+
+    size_t SeriesCount() const;
+    size_t DeadCount() const;
+    size_t ChunksUsed() const;
+    size_t ChunkCount() const { return pool.size(); }
+    size_t Evictions() const;
+    int64_t GraceMs() const { return grace_ms; }
+
+private:
+    struct Series {
+        ProcessKey key = {0, 0};
+        uint32_t chunks[kMaxChunks];   // pool indices, a ring; chunks[head] is being written
+        size_t head = 0;
+        size_t used = 0;
+        ChunkEncoder encoder;
+        int64_t last_t = INT64_MIN;
+        uint64_t seen = 0;             // generation of the last Update that found it
+        bool alive = false;
+        int64_t died_ms = 0;
+        int64_t viewed_ms = 0;         // 0: never viewed
+        bool in_use = false;
+
+        uint32_t Oldest(size_t i) const { return chunks[(head + kMaxChunks + 1 - used + i) % kMaxChunks]; }
+    };
+
+    bool Grow(Series& s);
+    bool TakeChunk(uint32_t& chunk, const Series& requester);
+    void Release(size_t slot);
+
+    mutable std::mutex lock;
+    std::vector<HistoryChunk> pool;
+    std::vector<uint32_t> free_chunks;
+    std::vector<Series> series;                  // slots; free ones are reused
+    std::vector<size_t> free_slots;
+    std::unordered_map<ProcessKey, size_t, ProcessKeyHash> index;
+    std::set<std::pair<int64_t, size_t>> dead;   // (viewed_ms, slot): eviction order
+    int64_t grace_ms;
+    uint64_t generation = 0;
+    size_t evictions = 0;
+};
+
+#endif
@@ -0,0 +1,74 @@
+#include "ProcessTable.h"
+#include <algorithm>
+#include <numeric>
+#include <functional>
+
+// --- STRING POOL ---
+// Commands come from cmdline, where arguments are NUL-separated; those NULs
+// are stored as spaces so each pooled string is a single C string
+static inline char Stored(char c) { return c == '\0' ? ' ' : c; }
+
+uint32_t StringPool::Intern(const std::string& text) {
+    size_t hash = std::hash<std::string>()(text);
+    auto range = lookup.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        const char* s = Get(it->second);
+        size_t i = 0;
+        while (i < text.size() && s[i] == Stored(text[i])) ++i;
+        if (i == text.size() && s[i] == '\0') return it->second;
+    }
+    uint32_t handle = (uint32_t)data.size();
+    for (char c : text) data.push_back(Stored(c));
+    data.push_back('\0');
+    lookup.emplace(hash, handle);
+    return handle;
+}
+
+void StringPool::Clear() {
+    data.clear();
+    lookup.clear();
+    generation++;
+}
+
+// --- PROCESS TABLE ---
+long ProcessTable::Find(int wanted) const {
+    for (size_t i = 0; i < pid.size(); ++i) {
+        if (pid[i] == wanted) return (long)i;
+    }
+    return -1;
+}
+
+void ProcessTable::Clear() {
+    pid.clear();
+    ppid.clear();
+    cpu.clear();
+    rss_mb.clear();
+    state.clear();
+    starttime.clear();
+    sampled_at.clear();
+    command.clear();
+    order.clear();
+}
+
+void ProcessTable::Append(const Process& p, uint32_t command_handle) {
+    pid.push_back(p.pid);
+    ppid.push_back(p.ppid);
+    cpu.push_back(p.cpuUsage);
+    rss_mb.push_back(p.memoryUsage);
+    state.push_back(p.state);
+    starttime.push_back(p.starttime);
+    sampled_at.push_back(p.sampled_at);
+    command.push_back(command_handle);
+}
+
+// Sorts row indices by one column; only `order` and that column are touched
+template <typename T, typename Compare>
+static void SortOrder(std::vector<uint32_t>& order, const std::vector<T>& column, Compare compare) {
+    order.resize(column.size());
+    std::iota(order.begin(), order.end(), 0u);
+    std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return compare(column[a], column[b]); });
+}
+
+void ProcessTable::SortByCpu() { SortOrder(order, cpu, std::greater<float>()); }
+void ProcessTable::SortByRss() { SortOrder(order, rss_mb, std::greater<float>()); }
+void ProcessTable::SortByPid() { SortOrder(order, pid, std::less<int>()); }
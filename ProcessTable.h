@@ -0,0 +1,71 @@
+#ifndef PROCESS_TABLE_H
+#define PROCESS_TABLE_H
+
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cstdint>
+#include <unordered_map>
+#include "Process.h"
+
+// Interns strings: equal strings share one handle, a byte offset into one
+// contiguous buffer of NUL-terminated strings. Handles stay valid until Clear().
+class StringPool {
+public:
+    uint32_t Intern(const std::string& text);
+    const char* Get(uint32_t handle) const { return data.data() + handle; }
+    const std::vector<char>& Data() const { return data; }
+    size_t Count() const { return lookup.size(); }
+    // Bumped by Clear(): handles from an older generation no longer name
+    // the same strings, even when they are still in range
+    uint32_t Generation() const { return generation; }
+    void Clear();
+
+private:
+    std::vector<char> data;
+    uint32_t generation = 0;
+    std::unordered_multimap<size_t, uint32_t> lookup; // hash -> handle
+};
+
+// Identifies a process across pid reuse: a reused pid has a new start time
+struct ProcessKey {
+    int pid;
+    long long starttime;
+    bool operator==(const ProcessKey& o) const { return pid == o.pid && starttime == o.starttime; }
+};
+
+struct ProcessKeyHash {
+    size_t operator()(const ProcessKey& k) const { return std::hash<long long>()(k.starttime * 4194304LL + k.pid); }
+};
+
+// Column-oriented process list: one contiguous array per field, commands as
+// 32-bit handles into an interned string buffer. Rows are never moved; sorting
+// writes a permutation into `order`. Clear() keeps capacity, so refilling and
+// re-sorting a table of a stable size does not allocate.
+struct ProcessTable {
+    std::vector<int> pid;
+    std::vector<int> ppid;
+    std::vector<float> cpu;             // percent of one CPU
+    std::vector<float> rss_mb;
+    std::vector<char> state;
+    std::vector<long long> starttime;
+    std::vector<std::chrono::steady_clock::time_point> sampled_at;
+    std::vector<uint32_t> command;      // handles into strings
+    std::vector<char> strings;          // copy of the producer's StringPool data
+    uint32_t pool_generation = 0;       // its Generation(): handles are comparable while this holds
+    std::vector<uint32_t> order;        // row indices in display order
+
+    size_t Size() const { return pid.size(); }
+    const char* Command(size_t row) const { return strings.data() + command[row]; }
+    // Row of pid, or -1; linear, for one-off lookups
+    long Find(int pid) const;
+
+    void Clear();
+    void Append(const Process& p, uint32_t command_handle);
+
+    void SortByCpu();                   // highest first
+    void SortByRss();                   // highest first
+    void SortByPid();
+};
+
+#endif
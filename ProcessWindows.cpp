@@ -0,0 +1,103 @@
+#include "ProcessWindows.h"
+#include <algorithm>
+
+static int64_t PaneMs(int window) { return ProcessWindows::kWindowMs[window] / ProcessWindows::kPanes; }
+
+// --- WINDOW ---
+void ProcessWindows::Window::Add(int64_t pane, float cpu, float rss) {
+    if (panes.empty() || panes.back().start != pane) panes.push_back({pane, 0.0, 0.0, 0});
+    Pane& p = panes.back();
+    p.cpu_sum += cpu;
+    p.rss_sum += rss;
+    p.count++;
+    cpu_sum += cpu;
+    rss_sum += rss;
+    count++;
+
+    // Entries no larger than the new value can never be the max again; one
+    // larger in the same pane outlives it, so the new value is not kept
+    for (std::deque<Peak>* peaks : {&cpu_max, &rss_max}) {
+        float value = peaks == &cpu_max ? cpu : rss;
+        while (!peaks->empty() && peaks->back().value <= value) peaks->pop_back();
+        if (peaks->empty() || peaks->back().pane != pane) peaks->push_back({pane, value});
+    }
+}
+
+void ProcessWindows::Window::Expire(int64_t oldest_pane) {
+    while (!panes.empty() && panes.front().start < oldest_pane) {
+        const Pane& p = panes.front();
+        cpu_sum -= p.cpu_sum;
+        rss_sum -= p.rss_sum;
+        count -= p.count;
+        panes.pop_front();
+    }
+    if (count == 0) cpu_sum = rss_sum = 0.0; // no rounding left behind
+    while (!cpu_max.empty() && cpu_max.front().pane < oldest_pane) cpu_max.pop_front();
+    while (!rss_max.empty() && rss_max.front().pane < oldest_pane) rss_max.pop_front();
+}
+
+float ProcessWindows::Window::Value(WindowAggregate agg) const {
+    switch (agg) {
+        case WINDOW_AVG_CPU: return (float)(cpu_sum / count);
+        case WINDOW_MAX_CPU: return cpu_max.front().value;
+        case WINDOW_AVG_RSS: return (float)(rss_sum / count);
+        case WINDOW_MAX_RSS: return rss_max.front().value;
+        default: return 0.0f;
+    }
+}
+
+// --- UPDATE ---
+void ProcessWindows::Update(const ProcessTable& table, std::chrono::steady_clock::time_point steady_now, int64_t now_ms) {
+    std::lock_guard<std::mutex> guard(lock);
+    generation++;
+    for (size_t row = 0; row < table.Size(); ++row) {
+        Series& s = series[{table.pid[row], table.starttime[row]}];
+        s.seen = generation;
+        const char* command = table.Command(row);
+        if (s.command != command) s.command = command; // exec keeps the pid and start time
+        int64_t t = now_ms - std::chrono::duration_cast<std::chrono::milliseconds>(steady_now - table.sampled_at[row]).count();
+        if (t <= s.last_t) continue; // not re-read since the last update
+        s.last_t = t;
+        for (int w = 0; w < kWindows; ++w) s.window[w].Add(t - t % PaneMs(w), table.cpu[row], table.rss_mb[row]);
+    }
+
+    // Slide every window; the pane holding now_ms and the kPanes - 1 before it stay
+    for (auto it = series.begin(); it != series.end();) {
+        for (int w = 0; w < kWindows; ++w) it->second.window[w].Expire(now_ms - now_ms % PaneMs(w) - (kPanes - 1) * PaneMs(w));
+        if (it->second.seen != generation && it->second.window[kWindows - 1].count == 0) it = series.erase(it);
+        else ++it;
+    }
+}
+
+// --- QUERIES ---
+size_t ProcessWindows::Top(int window, WindowAggregate agg, size_t n, std::vector<WindowRank>& out) const {
+    out.clear();
+    if (window < 0 || window >= kWindows || agg < 0 || agg >= WINDOW_AGGREGATE_COUNT || n == 0) return 0;
+    std::lock_guard<std::mutex> guard(lock);
+    // Candidates as (value, series), then only the top n are copied out
+    std::vector<std::pair<float, const std::pair<const ProcessKey, Series>*>> ranked;
+    ranked.reserve(series.size());
+    for (const auto& kv : series) {
+        const Window& win = kv.second.window[window];
+        if (win.count > 0) ranked.push_back({win.Value(agg), &kv});
+    }
+    n = std::min(n, ranked.size());
+    std::partial_sort(ranked.begin(), ranked.begin() + n, ranked.end(),
+                      [](const auto& a, const auto& b) { return a.first > b.first; });
+    for (size_t i = 0; i < n; ++i) {
+        const ProcessKey& key = ranked[i].second->first;
+        const Series& s = ranked[i].second->second;
+        out.push_back({key.pid, key.starttime, ranked[i].first, s.window[window].count, s.seen == generation, s.command});
+    }
+    return n;
+}
+
+size_t ProcessWindows::SeriesCount() const {
+    std::lock_guard<std::mutex> guard(lock);
+    return series.size();
+}
+
+const char* ProcessWindows::AggregateName(WindowAggregate agg) {
+    static const char* const kNames[WINDOW_AGGREGATE_COUNT] = {"avg_cpu", "max_cpu", "avg_rss", "max_rss"};
+    return agg >= 0 && agg < WINDOW_AGGREGATE_COUNT ? kNames[agg] : "";
+}
@@ -0,0 +1,89 @@
+#ifndef PROCESSWINDOWS_H
+#define PROCESSWINDOWS_H
+
+#include <deque>
+#include <mutex>
+#include <string>
+#include <chrono>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+#include "ProcessTable.h"
+
+enum WindowAggregate { WINDOW_AVG_CPU, WINDOW_MAX_CPU, WINDOW_AVG_RSS, WINDOW_MAX_RSS, WINDOW_AGGREGATE_COUNT };
+
+struct WindowRank {
+    int pid;
+    long long starttime;
+    float value;
+    uint32_t samples;       // in the window
+    bool alive;             // still in the process table
+    std::string command;
+};
+
+// Sliding-window CPU and RSS aggregates per process, kept up to date as
+// samples arrive so that ranking processes never rereads samples. Each
+// window is cut into kPanes panes: a sample adds to the sums of the newest
+// pane and to a monotonic deque of maxima (decreasing, at most one entry per
+// pane, so the front is the window's max); panes that slide out are
+// subtracted again and popped off the deques. Both are amortized O(1) per
+// sample, and a window's edge moves in steps of one pane.
+// A process that leaves the table keeps its aggregates until its last
+// sample has left the longest window.
+// All methods are thread-safe: the collector thread updates while the UI reads.
+class ProcessWindows {
+public:
+    static constexpr int kWindows = 3;
+    static constexpr int64_t kWindowMs[kWindows] = {60000, 300000, 3600000};
+    static constexpr int kPanes = 60;
+
+    // Adds every row sampled since its last update and slides every window
+    // to now_ms. steady_now and now_ms are the same instant.
+    void Update(const ProcessTable& table, std::chrono::steady_clock::time_point steady_now, int64_t now_ms);
+
+    // The n processes ranking highest by agg over kWindowMs[window], highest
+    // first, into out (cleared first). Costs one pass over the processes.
+    size_t Top(int window, WindowAggregate agg, size_t n, std::vector<WindowRank>& out) const;
+
+    size_t SeriesCount() const;
+
+    static const char* AggregateName(WindowAggregate agg);
+
+private:
+    struct Pane {
+        int64_t start;
+        double cpu_sum;
+        double rss_sum;
+        uint32_t count;
+    };
+    struct Peak {
+        int64_t pane;
+        float value;
+    };
+
+    struct Window {
+        std::deque<Pane> panes;    // oldest first
+        std::deque<Peak> cpu_max;  // values decreasing from the front
+        std::deque<Peak> rss_max;
+        double cpu_sum = 0.0;
+        double rss_sum = 0.0;
+        uint32_t count = 0;
+
+        void Add(int64_t pane, float cpu, float rss);
+        void Expire(int64_t oldest_pane);
+        float Value(WindowAggregate agg) const;
+    };
+
+    struct Series {
+        int64_t last_t = INT64_MIN;
+        uint64_t seen = 0;
+        std::string command;
+        Window window[kWindows];
+    };
+
+    mutable std::mutex lock;
+    std::unordered_map<ProcessKey, Series, ProcessKeyHash> series;
+    uint64_t generation = 0;
+};
+
+#endif
@@ -0,0 +1,106 @@
+#include "Quiet.h"
+#include "Parser.h"
+#include <cstring>
+#include <cstdlib>
+#include <cerrno>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <sys/resource.h>
+
+// From linux/ioprio.h, which older toolchains do not ship
+static const int kIoprioWhoProcess = 1;
+static const int kIoprioClassIdle = 3;
+static const int kIoprioClassShift = 13;
+
+static bool ParseInt(const char* text, long lo, long hi, long& out) {
+    char* end;
+    errno = 0;
+    out = strtol(text, &end, 10);
+    return errno == 0 && end != text && *end == '\0' && out >= lo && out <= hi;
+}
+
+bool Quiet::ParseArgs(int argc, char** argv, QuietConfig& out, std::string& error) {
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        long value;
+        if (strcmp(arg, "--quiet") == 0) {
+            out.enabled = true;
+        } else if (strncmp(arg, "--quiet-nice=", 13) == 0) {
+            if (!ParseInt(arg + 13, 0, 19, value)) { error = "--quiet-nice expects 0..19"; return false; }
+            out.nice = (int)value;
+            out.enabled = true;
+        } else if (strncmp(arg, "--quiet-cpus=", 13) == 0) {
+            out.cpus = Parser::CpuList(arg + 13);
+            if (out.cpus.empty()) { error = "--quiet-cpus expects a cpu list such as 0 or 0-1,4"; return false; }
+            out.enabled = true;
+        } else if (strncmp(arg, "--quiet-mem=", 12) == 0) {
+            if (!ParseInt(arg + 12, 1, 1 << 20, value)) { error = "--quiet-mem expects megabytes"; return false; }
+            out.memory_cap_mb = (size_t)value;
+            out.enabled = true;
+        }
+    }
+    return true;
+}
+
+const char* Quiet::Usage() {
+    return "  --quiet            run collectors under SCHED_IDLE with idle I/O priority\n"
+           "  --quiet-nice=N     use nice N (0..19) instead of SCHED_IDLE\n"
+           "  --quiet-cpus=LIST  pin collectors to these housekeeping CPUs, e.g. 0-1\n"
+           "  --quiet-mem=MB     cap the process data segment (RLIMIT_DATA)\n";
+}
+
+QuietStatus Quiet::Apply(const QuietConfig& config) {
+    QuietStatus status;
+    if (!config.enabled) return status;
+    status.enabled = true;
+    pid_t tid = (pid_t)syscall(SYS_gettid);
+    auto fail = [&status](const char* what) {
+        if (!status.errors.empty()) status.errors += "; ";
+        status.errors += std::string(what) + ": " + strerror(errno);
+    };
+
+    // --- CPU SCHEDULING ---
+    // On Linux both calls below act on the thread, not the whole process
+    if (config.nice < 0) {
+        sched_param param = {};
+        if (sched_setscheduler(0, SCHED_IDLE, &param) == 0) status.sched_idle = true;
+        else fail("SCHED_IDLE");
+    } else {
+        if (setpriority(PRIO_PROCESS, tid, config.nice) == 0) status.nice = config.nice;
+        else fail("nice");
+    }
+
+    // --- I/O PRIORITY ---
+    if (syscall(SYS_ioprio_set, kIoprioWhoProcess, tid, kIoprioClassIdle << kIoprioClassShift) == 0) status.io_idle = true;
+    else fail("ioprio_set");
+
+    // --- HOUSEKEEPING CPUS ---
+    if (!config.cpus.empty()) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu : config.cpus) {
+            if (cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+        }
+        if (sched_setaffinity(0, sizeof(set), &set) == 0) {
+            for (int cpu : config.cpus) {
+                if (!status.cpus.empty()) status.cpus += ",";
+                status.cpus += std::to_string(cpu);
+            }
+        } else {
+            fail("affinity");
+        }
+    }
+
+    // --- MEMORY CAP ---
+    if (config.memory_cap_mb > 0) {
+        rlimit limit;
+        getrlimit(RLIMIT_DATA, &limit);
+        rlim_t cap = (rlim_t)config.memory_cap_mb << 20;
+        if (limit.rlim_max != RLIM_INFINITY && limit.rlim_max < cap) cap = limit.rlim_max;
+        limit.rlim_cur = cap;
+        if (setrlimit(RLIMIT_DATA, &limit) == 0) status.memory_cap_mb = (size_t)(cap >> 20);
+        else fail("RLIMIT_DATA");
+    }
+    return status;
+}
@@ -0,0 +1,40 @@
+#ifndef QUIET_H
+#define QUIET_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+// Low-interference mode for running next to latency-sensitive services
+struct QuietConfig {
+    bool enabled = false;
+    int nice = -1;              // >= 0: renice to this instead of SCHED_IDLE
+    std::vector<int> cpus;      // housekeeping CPUs; empty leaves affinity alone
+    size_t memory_cap_mb = 0;   // 0: no cap
+};
+
+// What actually took effect; each step can fail without privileges or on old kernels
+struct QuietStatus {
+    bool enabled = false;
+    bool sched_idle = false;
+    int nice = 0;
+    bool io_idle = false;
+    std::string cpus;           // affinity that was applied, as a cpulist; empty if unchanged
+    size_t memory_cap_mb = 0;
+    std::string errors;
+};
+
+namespace Quiet {
+    // Accepts --quiet, --quiet-nice=N, --quiet-cpus=LIST and --quiet-mem=MB (any of
+    // the last three implies --quiet). Unrelated arguments are ignored; returns
+    // false with a message on a malformed value.
+    bool ParseArgs(int argc, char** argv, QuietConfig& out, std::string& error);
+    const char* Usage();
+
+    // Scheduling class, I/O priority and affinity apply to the calling thread
+    // and whatever it spawns later. Linux has no per-thread memory limit, so the
+    // cap is RLIMIT_DATA for the whole process.
+    QuietStatus Apply(const QuietConfig& config);
+}
+
+#endif
@@ -0,0 +1,534 @@
+#include "Recording.h"
+#include <cstring>
+#include <climits>
+#include <algorithm>
+#include <type_traits>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+using Recording::Row;
+
+static const char kMagic[8] = {'N', 'M', 'R', 'E', 'C', '0', '0', '1'};
+static const uint32_t kVersion = 1;
+static const size_t kFileHeaderBytes = 16;
+static const size_t kFrameHeaderBytes = 4 + 4 + 8 + 1;
+
+// --- ENCODING ---
+namespace {
+
+class Out {
+public:
+    explicit Out(std::vector<uint8_t>& buf) : buf(buf) {}
+
+    void Bytes(const void* p, size_t n) { buf.insert(buf.end(), (const uint8_t*)p, (const uint8_t*)p + n); }
+    template <typename T> void Pod(const T& v) {
+        static_assert(std::is_trivially_copyable<T>::value, "raw copies only");
+        Bytes(&v, sizeof(v));
+    }
+    void Varint(uint64_t v) {
+        while (v >= 0x80) {
+            buf.push_back((uint8_t)(v | 0x80));
+            v >>= 7;
+        }
+        buf.push_back((uint8_t)v);
+    }
+    void Svarint(int64_t v) { Varint(((uint64_t)v << 1) ^ (uint64_t)(v >> 63)); }
+    void String(const char* s, size_t n) {
+        Varint(n);
+        Bytes(s, n);
+    }
+    void String(const std::string& s) { String(s.data(), s.size()); }
+    template <typename T> void PodVector(const std::vector<T>& v) {
+        static_assert(std::is_trivially_copyable<T>::value, "raw copies only");
+        Varint(v.size());
+        if (!v.empty()) Bytes(v.data(), v.size() * sizeof(T));
+    }
+
+private:
+    std::vector<uint8_t>& buf;
+};
+
+// Reads past the end yield zeros and clear ok, so a damaged frame decodes to empty data
+class In {
+public:
+    In(const uint8_t* p, size_t n) : p(p), end(p + n) {}
+
+    bool ok = true;
+
+    bool Bytes(void* out, size_t n) {
+        if ((size_t)(end - p) < n) {
+            ok = false;
+            memset(out, 0, n);
+            return false;
+        }
+        memcpy(out, p, n);
+        p += n;
+        return true;
+    }
+    template <typename T> T Pod() {
+        T v;
+        Bytes(&v, sizeof(v));
+        return v;
+    }
+    uint64_t Varint() {
+        uint64_t v = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (p >= end) {
+                ok = false;
+                return 0;
+            }
+            uint8_t b = *p++;
+            v |= (uint64_t)(b & 0x7F) << shift;
+            if (!(b & 0x80)) return v;
+        }
+        ok = false;
+        return v;
+    }
+    int64_t Svarint() {
+        uint64_t v = Varint();
+        return (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+    }
+    size_t Left() const { return (size_t)(end - p); }
+    // Length-checked against what is left, so a bad count cannot allocate wildly
+    size_t Count(size_t item_bytes) {
+        uint64_t n = Varint();
+        if (n > (uint64_t)(end - p) / (item_bytes ? item_bytes : 1)) {
+            ok = false;
+            return 0;
+        }
+        return (size_t)n;
+    }
+    std::string String() {
+        size_t n = Count(1);
+        std::string s((const char*)p, n);
+        p += n;
+        return s;
+    }
+    template <typename T> void PodVector(std::vector<T>& v) {
+        v.resize(Count(sizeof(T)));
+        if (!v.empty()) Bytes(v.data(), v.size() * sizeof(T));
+    }
+
+private:
+    const uint8_t* p;
+    const uint8_t* end;
+};
+
+void PutIrq(Out& out, const IrqMatrix& m) {
+    out.PodVector(m.cpus);
+    out.Varint(m.names.size());
+    for (size_t i = 0; i < m.names.size(); ++i) {
+        out.String(m.names[i]);
+        out.String(i < m.descriptions.size() ? m.descriptions[i] : std::string());
+    }
+    out.PodVector(m.rates);
+}
+
+void GetIrq(In& in, IrqMatrix& m) {
+    in.PodVector(m.cpus);
+    size_t n = in.Count(2);
+    m.names.resize(n);
+    m.descriptions.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        m.names[i] = in.String();
+        m.descriptions[i] = in.String();
+    }
+    in.PodVector(m.rates);
+    if (m.rates.size() != m.names.size() * m.cpus.size()) m.rates.assign(m.names.size() * m.cpus.size(), 0.0f);
+}
+
+// Process row; the command only when new or changed (length + 1, 0 = unchanged)
+void PutRow(Out& out, int pid, const Row& r, int64_t t_ms, bool with_command) {
+    out.Svarint(pid);
+    out.Svarint(r.ppid);
+    out.Pod(r.cpu);
+    out.Pod(r.rss_mb);
+    out.Pod(r.state);
+    out.Svarint(r.starttime);
+    out.Svarint(t_ms - r.sampled_ms);
+    if (with_command) {
+        out.Varint(r.command.size() + 1);
+        out.Bytes(r.command.data(), r.command.size());
+    } else {
+        out.Varint(0);
+    }
+}
+
+} // namespace
+
+// --- RECORDER ---
+bool SessionRecorder::Open(const std::string& path, std::string& error) {
+    Close();
+    file = fopen(path.c_str(), "wb");
+    if (!file) {
+        error = std::string("cannot create ") + path + ": " + strerror(errno);
+        return false;
+    }
+    index = fopen((path + ".idx").c_str(), "wb");
+    if (!index) {
+        error = std::string("cannot create ") + path + ".idx: " + strerror(errno);
+        Close();
+        return false;
+    }
+    setvbuf(file, nullptr, _IOFBF, 1 << 20);
+    uint32_t header[2] = {kVersion, 0};
+    fwrite(kMagic, 1, sizeof(kMagic), file);
+    fwrite(header, 1, sizeof(header), file);
+    offset = kFileHeaderBytes;
+    frames = 0;
+    last_key = INT64_MIN;
+    recorded.fill(0);
+    rows.clear();
+    return true;
+}
+
+void SessionRecorder::Close() {
+    if (file) fclose(file);
+    if (index) fclose(index);
+    file = index = nullptr;
+}
+
+void SessionRecorder::Write(const Snapshot& snap, int64_t t_ms, std::chrono::steady_clock::time_point steady_now) {
+    if (!file) return;
+    bool key = last_key == INT64_MIN || t_ms - last_key >= kKeyframeMs;
+    uint32_t mask = 0;
+    for (int s = 0; s < SECTION_COUNT; ++s) {
+        if (key || snap.versions[s] != recorded[s]) mask |= 1u << s;
+        recorded[s] = snap.versions[s];
+    }
+    if (mask == 0) return;
+
+    frame.assign(kFrameHeaderBytes, 0);
+    Out out(frame);
+    for (int s = 0; s < SECTION_COUNT; ++s) {
+        if (!(mask & (1u << s))) continue;
+        switch (s) {
+            case SECTION_CPU: out.Pod(snap.cpu); break;
+            case SECTION_MEMORY: out.Pod(snap.mem); break;
+            case SECTION_NETWORK:
+                out.Pod(snap.net.first);
+                out.Pod(snap.net.second);
+                break;
+            case SECTION_CONNECTIVITY: out.Pod((uint8_t)snap.online); break;
+            case SECTION_BATTERY: out.Pod(snap.battery); break;
+            case SECTION_DISKS:
+                out.Varint(snap.disks.size());
+                for (const auto& d : snap.disks) {
+                    out.String(d.name);
+                    out.Pod(d.total_bytes);
+                    out.Pod(d.used_bytes);
+                    out.Pod(d.percent_used);
+                }
+                break;
+            case SECTION_PROCESSES: {
+                out.Pod(snap.sweep);
+                const ProcessTable& t = snap.procs;
+                // Upserts are counted after the fact, so they go to a side buffer
+                upserts.clear();
+                removed.clear();
+                Out rows_out(upserts);
+                size_t changed = 0;
+                for (size_t i = 0; i < t.Size(); ++i) {
+                    auto it = rows.find(t.pid[i]);
+                    bool fresh = it == rows.end();
+                    if (fresh) it = rows.emplace(t.pid[i], Row()).first;
+                    Row& r = it->second;
+                    bool command_changed = fresh || r.command != t.Command(i);
+                    bool differs = key || command_changed || r.ppid != t.ppid[i] || r.cpu != t.cpu[i] || r.rss_mb != t.rss_mb[i] ||
+                                   r.state != t.state[i] || r.starttime != t.starttime[i] || r.sampled_at != t.sampled_at[i];
+                    r.seen = frames + 1;
+                    if (!differs) continue;
+                    r.ppid = t.ppid[i];
+                    r.cpu = t.cpu[i];
+                    r.rss_mb = t.rss_mb[i];
+                    r.state = t.state[i];
+                    r.starttime = t.starttime[i];
+                    r.sampled_at = t.sampled_at[i];
+                    r.sampled_ms = t_ms - std::chrono::duration_cast<std::chrono::milliseconds>(steady_now - t.sampled_at[i]).count();
+                    if (command_changed) r.command = t.Command(i);
+                    PutRow(rows_out, t.pid[i], r, t_ms, key || command_changed);
+                    changed++;
+                }
+                for (auto it = rows.begin(); it != rows.end();) {
+                    if (it->second.seen == frames + 1) {
+                        ++it;
+                        continue;
+                    }
+                    removed.push_back(it->first);
+                    it = rows.erase(it);
+                }
+                out.Varint(removed.size());
+                for (int pid : removed) out.Svarint(pid);
+                out.Varint(changed);
+                out.Bytes(upserts.data(), upserts.size());
+                break;
+            }
+            case SECTION_SOCKETS: out.PodVector(snap.sockets); break;
+            case SECTION_FDS: out.PodVector(snap.fds); break;
+            case SECTION_KERNEL: out.Pod(snap.kernel); break;
+            case SECTION_INTERRUPTS:
+                PutIrq(out, snap.irq);
+                PutIrq(out, snap.softirq);
+                break;
+            case SECTION_NUMA:
+                out.PodVector(snap.numa);
+                out.Pod(snap.numa_proc.pid);
+                out.Pod(snap.numa_proc.home_node);
+                out.PodVector(snap.numa_proc.node_ids);
+                out.PodVector(snap.numa_proc.node_kb);
+                out.Pod(snap.numa_proc.total_kb);
+                out.Pod(snap.numa_proc.local_percent);
+                break;
+            case SECTION_SELF: out.Pod(snap.self); break;
+        }
+    }
+
+    uint32_t payload = (uint32_t)(frame.size() - kFrameHeaderBytes);
+    memcpy(&frame[0], &payload, 4);
+    memcpy(&frame[4], &mask, 4);
+    memcpy(&frame[8], &t_ms, 8);
+    frame[16] = key ? 1 : 0;
+    uint64_t at = offset;
+    fwrite(frame.data(), 1, frame.size(), file);
+    offset += frame.size();
+    frames++;
+    if (key) {
+        // Index entries only ever point at frames already handed to the kernel
+        last_key = t_ms;
+        fflush(file);
+        int64_t entry[2] = {t_ms, (int64_t)at};
+        fwrite(entry, sizeof(entry), 1, index);
+        fflush(index);
+    }
+}
+
+// --- PLAYER ---
+bool SessionPlayer::Open(const std::string& path, std::string& error) {
+    Close();
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        error = std::string("cannot open ") + path + ": " + strerror(errno);
+        return false;
+    }
+    struct stat st;
+    void* p = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && (size_t)st.st_size >= kFileHeaderBytes)
+        p = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) {
+        error = path + ": not a recording";
+        return false;
+    }
+    map = (const uint8_t*)p;
+    size = (size_t)st.st_size;
+    uint32_t version;
+    memcpy(&version, map + 8, 4);
+    if (memcmp(map, kMagic, sizeof(kMagic)) != 0 || version != kVersion) {
+        error = path + ": not a recording, or from another version";
+        Close();
+        return false;
+    }
+
+    // Trust the index as far as each entry lands on a keyframe with its time,
+    // then scan on from the last one for what the index does not cover yet
+    FILE* idx = fopen((path + ".idx").c_str(), "rb");
+    int64_t entry[2];
+    while (idx && fread(entry, sizeof(entry), 1, idx) == 1) {
+        int64_t t;
+        bool keyframe;
+        uint64_t after;
+        if (!Frame((uint64_t)entry[1], t, keyframe, after) || !keyframe || t != entry[0]) break;
+        if (!keys.empty() && (uint64_t)entry[1] <= keys.back().offset) break;
+        keys.push_back({entry[0], (uint64_t)entry[1]});
+    }
+    if (idx) fclose(idx);
+    uint64_t from = keys.empty() ? kFileHeaderBytes : keys.back().offset;
+    if (!keys.empty()) keys.pop_back(); // Scan() lists it again
+    Scan(from);
+    if (keys.empty()) {
+        error = path + ": no complete keyframe";
+        Close();
+        return false;
+    }
+    start_ms = keys.front().t_ms;
+    return true;
+}
+
+void SessionPlayer::Close() {
+    if (map) munmap((void*)map, size);
+    map = nullptr;
+    size = end = next = 0;
+    keys.clear();
+    rows.clear();
+    commands.Clear();
+}
+
+// Header of the frame at `at`; false if it is cut short
+bool SessionPlayer::Frame(uint64_t at, int64_t& t_ms, bool& keyframe, uint64_t& after) const {
+    if (at < kFileHeaderBytes || at + kFrameHeaderBytes > size) return false;
+    uint32_t payload;
+    memcpy(&payload, map + at, 4);
+    memcpy(&t_ms, map + at + 8, 8);
+    keyframe = map[at + 16] != 0;
+    after = at + kFrameHeaderBytes + payload;
+    return after <= size;
+}
+
+void SessionPlayer::Scan(uint64_t from) {
+    end = from;
+    int64_t t;
+    bool keyframe;
+    uint64_t after;
+    while (Frame(end, t, keyframe, after)) {
+        if (keyframe) keys.push_back({t, end});
+        end_ms = t;
+        end = after;
+    }
+}
+
+void SessionPlayer::Seek(int64_t t_ms, Snapshot& out) {
+    if (!map) return;
+    // Last keyframe at or before t_ms (the first one for earlier times)
+    auto it = std::upper_bound(keys.begin(), keys.end(), t_ms, [](int64_t t, const Key& k) { return t < k.t_ms; });
+    if (it != keys.begin()) --it;
+    out = Snapshot();
+    rows.clear();
+    commands.Clear();
+    next = it->offset;
+    Advance(std::max(t_ms, it->t_ms), out);
+}
+
+bool SessionPlayer::Advance(int64_t t_ms, Snapshot& out) {
+    if (!map) return false;
+    int64_t t;
+    bool keyframe;
+    uint64_t after;
+    while (next < end && Frame(next, t, keyframe, after) && t <= t_ms) {
+        Apply(next, out);
+        position_ms = t;
+        next = after;
+    }
+    return next < end;
+}
+
+bool SessionPlayer::Step(Snapshot& out) {
+    int64_t t;
+    bool keyframe;
+    uint64_t after;
+    if (!map || next >= end || !Frame(next, t, keyframe, after)) return false;
+    Apply(next, out);
+    position_ms = t;
+    next = after;
+    return true;
+}
+
+void SessionPlayer::Apply(uint64_t at, Snapshot& out) {
+    uint32_t payload, mask;
+    int64_t t_ms;
+    memcpy(&payload, map + at, 4);
+    memcpy(&mask, map + at + 4, 4);
+    memcpy(&t_ms, map + at + 8, 8);
+    In in(map + at + kFrameHeaderBytes, payload);
+    std::chrono::steady_clock::time_point steady_now = std::chrono::steady_clock::now();
+    out.sequence++;
+    applied++;
+
+    for (int s = 0; s < SECTION_COUNT && in.ok; ++s) {
+        if (!(mask & (1u << s))) continue;
+        out.versions[s] = applied;
+        out.sampled_at[s] = steady_now;
+        switch (s) {
+            case SECTION_CPU: out.cpu = in.Pod<float>(); break;
+            case SECTION_MEMORY: out.mem = in.Pod<float>(); break;
+            case SECTION_NETWORK:
+                out.net.first = in.Pod<float>();
+                out.net.second = in.Pod<float>();
+                break;
+            case SECTION_CONNECTIVITY: out.online = in.Pod<uint8_t>() != 0; break;
+            case SECTION_BATTERY: out.battery = in.Pod<int>(); break;
+            case SECTION_DISKS:
+                out.disks.resize(in.Count(1));
+                for (auto& d : out.disks) {
+                    d.name = in.String();
+                    d.total_bytes = in.Pod<long>();
+                    d.used_bytes = in.Pod<long>();
+                    d.percent_used = in.Pod<float>();
+                }
+                break;
+            case SECTION_PROCESSES: {
+                out.sweep = in.Pod<SweepStats>();
+                size_t removed = in.Count(1);
+                for (size_t i = 0; i < removed; ++i) rows.erase((int)in.Svarint());
+                size_t changed = in.Count(1);
+                for (size_t i = 0; i < changed && in.ok; ++i) {
+                    int pid = (int)in.Svarint();
+                    Row& r = rows[pid];
+                    r.ppid = (int)in.Svarint();
+                    r.cpu = in.Pod<float>();
+                    r.rss_mb = in.Pod<float>();
+                    r.state = in.Pod<char>();
+                    r.starttime = in.Svarint();
+                    r.sampled_ms = t_ms - in.Svarint();
+                    // Length + 1, so the last row of a frame may claim one byte more than is left
+                    uint64_t command = in.Varint();
+                    if (command > (uint64_t)in.Left() + 1) in.ok = false;
+                    else if (command > 0) {
+                        std::string text(command - 1, '\0');
+                        in.Bytes(&text[0], command - 1);
+                        r.handle = commands.Intern(text);
+                    }
+                }
+                // Exited processes leave their commands behind; rebuild the pool
+                // once those outnumber the live ones, as the sweep does
+                if (commands.Count() > 2 * rows.size() + 1024) {
+                    StringPool old = commands;
+                    commands.Clear();
+                    for (auto& kv : rows) kv.second.handle = commands.Intern(old.Get(kv.second.handle));
+                }
+                // Rebuilt from the rows, with ages as they were at the frame's time
+                ProcessTable& table = out.procs;
+                table.Clear();
+                for (const auto& kv : rows) {
+                    const Row& r = kv.second;
+                    table.pid.push_back(kv.first);
+                    table.ppid.push_back(r.ppid);
+                    table.cpu.push_back(r.cpu);
+                    table.rss_mb.push_back(r.rss_mb);
+                    table.state.push_back(r.state);
+                    table.starttime.push_back(r.starttime);
+                    table.sampled_at.push_back(steady_now - std::chrono::milliseconds(t_ms - r.sampled_ms));
+                    table.command.push_back(r.handle);
+                }
+                table.strings = commands.Data();
+                table.pool_generation = commands.Generation();
+                table.SortByCpu();
+                break;
+            }
+            case SECTION_SOCKETS:
+                in.PodVector(out.sockets);
+                out.conn_count.clear();
+                for (const auto& sock : out.sockets) {
+                    if (sock.pid >= 0) out.conn_count[sock.pid]++;
+                }
+                break;
+            case SECTION_FDS: in.PodVector(out.fds); break;
+            case SECTION_KERNEL: out.kernel = in.Pod<KernelActivity>(); break;
+            case SECTION_INTERRUPTS:
+                GetIrq(in, out.irq);
+                GetIrq(in, out.softirq);
+                break;
+            case SECTION_NUMA:
+                in.PodVector(out.numa);
+                out.numa_proc.pid = in.Pod<int>();
+                out.numa_proc.home_node = in.Pod<int>();
+                in.PodVector(out.numa_proc.node_ids);
+                in.PodVector(out.numa_proc.node_kb);
+                out.numa_proc.total_kb = in.Pod<long>();
+                out.numa_proc.local_percent = in.Pod<float>();
+                break;
+            case SECTION_SELF: out.self = in.Pod<SelfUsage>(); break;
+        }
+    }
+}
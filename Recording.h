@@ -0,0 +1,124 @@
+#ifndef RECORDING_H
+#define RECORDING_H
+
+#include <map>
+#include <array>
+#include <atomic>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include "Snapshot.h"
+
+// Session recordings: the snapshots the dashboard showed, as a stream of
+// binary frames. Native byte order and struct layout, so a recording is read
+// back on the machine type that wrote it.
+//
+//   file:   "NMREC001" (8 bytes), uint32 version, uint32 reserved
+//   frame:  uint32 payload bytes, uint32 section mask, int64 wall ms, uint8 keyframe, payload
+//   payload: for each section in the mask, in SnapshotSection order, its data
+//
+// A keyframe carries every section; other frames only the sections whose
+// version changed, and the process section only as removed pids plus rows
+// that are new or differ from the previous frame. Keyframes are written at
+// least every kKeyframeMs and listed in "<path>.idx" as (int64 wall ms,
+// uint64 offset) pairs, appended after the frames they point at are
+// flushed. A crash loses at most the frames since the last keyframe; a
+// missing index is rebuilt by scanning the file.
+
+namespace Recording {
+struct Row {
+    int ppid;
+    float cpu;
+    float rss_mb;
+    char state;
+    long long starttime;
+    int64_t sampled_ms;     // wall clock
+    std::string command;    // writer only
+    uint32_t handle;        // reader only: into its StringPool
+    uint64_t seen;          // writer only: frame that last listed it
+    std::chrono::steady_clock::time_point sampled_at; // writer only, for change detection
+};
+}
+
+class SessionRecorder {
+public:
+    static constexpr int64_t kKeyframeMs = 10000;
+
+    SessionRecorder() = default;
+    ~SessionRecorder() { Close(); }
+    SessionRecorder(const SessionRecorder&) = delete;
+    SessionRecorder& operator=(const SessionRecorder&) = delete;
+
+    bool Open(const std::string& path, std::string& error); // truncates
+    void Close();
+    bool IsOpen() const { return file != nullptr; }
+
+    // Appends the sections that changed since the previous call (all of them
+    // on a keyframe). t_ms and steady_now are the same instant.
+    void Write(const Snapshot& snap, int64_t t_ms, std::chrono::steady_clock::time_point steady_now);
+
+    uint64_t BytesWritten() const { return offset; }
+    uint64_t Frames() const { return frames; }
+
+private:
+    FILE* file = nullptr;
+    FILE* index = nullptr;
+    std::vector<uint8_t> frame;
+    std::vector<uint8_t> upserts;         // process rows of the frame being built
+    std::vector<int> removed;
+    std::array<uint64_t, SECTION_COUNT> recorded{};
+    std::map<int, Recording::Row> rows;   // process rows as of the previous frame
+    int64_t last_key = INT64_MIN;
+    std::atomic<uint64_t> offset{0};   // atomic: the UI thread shows them
+    std::atomic<uint64_t> frames{0};
+};
+
+class SessionPlayer {
+public:
+    SessionPlayer() = default;
+    ~SessionPlayer() { Close(); }
+    SessionPlayer(const SessionPlayer&) = delete;
+    SessionPlayer& operator=(const SessionPlayer&) = delete;
+
+    bool Open(const std::string& path, std::string& error);
+    void Close();
+    bool IsOpen() const { return map != nullptr; }
+
+    int64_t StartMs() const { return start_ms; }
+    int64_t EndMs() const { return end_ms; }
+    int64_t PositionMs() const { return position_ms; }
+    size_t Keyframes() const { return keys.size(); }
+
+    // Rebuilds out as of t_ms: from the last keyframe at or before it, then forward
+    void Seek(int64_t t_ms, Snapshot& out);
+    // Applies the frames after the current position up to t_ms; false once past the last frame
+    bool Advance(int64_t t_ms, Snapshot& out);
+    // Applies the next frame alone; false if there is none
+    bool Step(Snapshot& out);
+
+private:
+    struct Key {
+        int64_t t_ms;
+        uint64_t offset;
+    };
+
+    bool Frame(uint64_t at, int64_t& t_ms, bool& keyframe, uint64_t& next) const;
+    void Scan(uint64_t from);
+    void Apply(uint64_t at, Snapshot& out);
+
+    const uint8_t* map = nullptr;
+    size_t size = 0;
+    uint64_t end = 0;              // end of the last complete frame
+    std::vector<Key> keys;
+    int64_t start_ms = 0;
+    int64_t end_ms = 0;
+    int64_t position_ms = 0;
+    uint64_t next = 0;             // offset of the next frame to apply
+    uint64_t applied = 0;          // stands in for section versions
+    std::map<int, Recording::Row> rows;
+    StringPool commands;
+};
+
+#endif
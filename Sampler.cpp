@@ -0,0 +1,174 @@
+#include "Sampler.h"
+#include "Collectors.h"
+#include <chrono>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/timerfd.h>
+#include <sys/eventfd.h>
+
+// --- HISTORY SERIES ---
+// Fixed series, registered up front so recording never builds a name
+enum FixedSeries {
+    SERIES_CPU, SERIES_MEM, SERIES_NET_RX, SERIES_NET_TX,
+    SERIES_PGFAULT, SERIES_PGMAJFAULT, SERIES_PSWPIN, SERIES_PSWPOUT, SERIES_CTXT, SERIES_INTR, SERIES_FORKS,
+    SERIES_RUNNING, SERIES_BLOCKED, SERIES_SELF_CPU, SERIES_SELF_RSS, SERIES_COUNT
+};
+
+static const char* kSeriesNames[SERIES_COUNT] = {
+    "cpu", "mem", "net.rx_kbs", "net.tx_kbs",
+    "kernel.pgfault", "kernel.pgmajfault", "kernel.pswpin", "kernel.pswpout", "kernel.ctxt", "kernel.intr", "kernel.forks",
+    "kernel.procs_running", "kernel.procs_blocked", "self.cpu", "self.rss_mb"
+};
+
+// Placeholder for dynamic series not registered yet (kNoSeries means "no room")
+static const int kUnregistered = -2;
+
+Sampler::Sampler(float cpu_budget, size_t history_budget, const std::string& history_path)
+    : history(history_budget, history_path), proc_history(new ProcessHistory()) {
+    for (int i = 0; i < SERIES_COUNT; ++i) fixed_series.push_back(history.Register(kSeriesNames[i]));
+    RegisterBuiltinCollectors(registry, system);
+    registry.Start(cpu_budget);
+    // steady_clock is CLOCK_MONOTONIC on Linux, so scheduler deadlines can be armed as-is
+    timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+    wake_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+}
+
+Sampler::~Sampler() {
+    Stop();
+    if (timer_fd >= 0) close(timer_fd);
+    if (wake_fd >= 0) close(wake_fd);
+}
+
+void Sampler::Start() {
+    if (running.exchange(true)) return;
+    worker = std::thread(&Sampler::Run, this);
+}
+
+void Sampler::Stop() {
+    if (!running.exchange(false)) return;
+    if (wake_fd >= 0) eventfd_write(wake_fd, 1);
+    if (worker.joinable()) worker.join();
+}
+
+void Sampler::Record() {
+    // Sections carry the steady_clock time they were read at; history is wall clock
+    std::chrono::steady_clock::time_point steady_now = std::chrono::steady_clock::now();
+    std::chrono::system_clock::time_point wall_now = std::chrono::system_clock::now();
+    for (int s = 0; s < SECTION_COUNT; ++s) {
+        if (recorded[s] == work.versions[s]) continue;
+        recorded[s] = work.versions[s];
+        std::chrono::system_clock::time_point wall = wall_now - std::chrono::duration_cast<std::chrono::system_clock::duration>(steady_now - work.sampled_at[s]);
+        int64_t t = std::chrono::duration_cast<std::chrono::milliseconds>(wall.time_since_epoch()).count();
+        auto put = [&](int series, float value) { history.Append(fixed_series[series], t, value); };
+        switch (s) {
+            case SECTION_CPU: put(SERIES_CPU, work.cpu); break;
+            case SECTION_MEMORY: put(SERIES_MEM, work.mem); break;
+            case SECTION_NETWORK:
+                put(SERIES_NET_RX, work.net.first);
+                put(SERIES_NET_TX, work.net.second);
+                break;
+            case SECTION_KERNEL:
+                put(SERIES_PGFAULT, work.kernel.pgfault);
+                put(SERIES_PGMAJFAULT, work.kernel.pgmajfault);
+                put(SERIES_PSWPIN, work.kernel.pswpin);
+                put(SERIES_PSWPOUT, work.kernel.pswpout);
+                put(SERIES_CTXT, work.kernel.ctxt);
+                put(SERIES_INTR, work.kernel.intr);
+                put(SERIES_FORKS, work.kernel.forks);
+                put(SERIES_RUNNING, (float)work.kernel.procs_running);
+                put(SERIES_BLOCKED, (float)work.kernel.procs_blocked);
+                break;
+            case SECTION_SELF:
+                put(SERIES_SELF_CPU, work.self.cpu_percent);
+                put(SERIES_SELF_RSS, work.self.rss_kb / 1024.0f);
+                break;
+            case SECTION_INTERRUPTS: {
+                // Interrupt rate per CPU, summed over sources
+                const IrqMatrix& irq = work.irq;
+                for (size_t c = 0; c < irq.cpus.size(); ++c) {
+                    size_t cpu = (size_t)irq.cpus[c];
+                    if (cpu >= cpu_irq_series.size()) cpu_irq_series.resize(cpu + 1, kUnregistered);
+                    int& id = cpu_irq_series[cpu];
+                    if (id == kUnregistered) id = history.Register("irq.cpu" + std::to_string(cpu));
+                    float sum = 0.0f;
+                    for (size_t r = 0; r < irq.names.size(); ++r) sum += irq.Rate(r, c);
+                    history.Append(id, t, sum);
+                }
+                break;
+            }
+            case SECTION_PROCESSES: {
+                int64_t now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(wall_now.time_since_epoch()).count();
+                proc_history->Update(work.procs, steady_now, now_ms);
+                windows.Update(work.procs, steady_now, now_ms);
+                break;
+            }
+            case SECTION_DISKS:
+                for (const auto& disk : work.disks) {
+                    auto it = disk_series.find(disk.name);
+                    if (it == disk_series.end()) it = disk_series.emplace(disk.name, history.Register("disk." + disk.name)).first;
+                    history.Append(it->second, t, disk.percent_used);
+                }
+                break;
+        }
+    }
+}
+
+void Sampler::Publish() {
+    work.sequence++;
+    Record();
+    registry.Describe(work.cadence);
+    if (recorder.IsOpen()) {
+        std::chrono::steady_clock::time_point steady_now = std::chrono::steady_clock::now();
+        int64_t now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+        recorder.Write(work, now_ms, steady_now);
+    }
+
+    // The slot we get back is three publishes old: copy only what changed since then
+    Snapshot& slot = buffer.WriteSlot();
+    slot.sequence = work.sequence;
+    slot.cadence = work.cadence;
+    slot.selected_pid = work.selected_pid;
+    registry.CopyOut(work, slot);
+    buffer.Publish();
+}
+
+void Sampler::Run() {
+    quiet_status = Quiet::Apply(quiet_config);
+    quiet_ready.store(true, std::memory_order_release);
+
+    while (running.load()) {
+        Scheduler::Clock::time_point next;
+        work.selected_pid = selected_pid.load(std::memory_order_relaxed);
+        if (registry.RunDue(work, scratch, next) > 0) Publish();
+        scratch.Reset();
+        Scheduler::Clock::time_point now = Scheduler::Clock::now();
+        if (now >= next_flush) {
+            history.Flush();
+            next_flush = now + std::chrono::seconds(1);
+        }
+        SleepUntil(next);
+    }
+}
+
+void Sampler::SleepUntil(Scheduler::Clock::time_point deadline) {
+    struct pollfd fds[2];
+    int nfds = 0;
+    int timeout_ms = -1;
+    if (timer_fd >= 0) {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline.time_since_epoch()).count();
+        struct itimerspec spec = {};
+        spec.it_value.tv_sec = ns / 1000000000;
+        spec.it_value.tv_nsec = ns % 1000000000;
+        if (spec.it_value.tv_sec == 0 && spec.it_value.tv_nsec == 0) spec.it_value.tv_nsec = 1; // zero would disarm
+        timerfd_settime(timer_fd, TFD_TIMER_ABSTIME, &spec, nullptr);
+        fds[nfds++] = {timer_fd, POLLIN, 0};
+    } else {
+        auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Scheduler::Clock::now()).count();
+        timeout_ms = left > 0 ? (int)left + 1 : 0;
+    }
+    if (wake_fd >= 0) fds[nfds++] = {wake_fd, POLLIN, 0};
+
+    // A deadline already passed fires at once; re-arming resets the expiration
+    // count, so the timerfd never needs draining. EINTR just means another pass.
+    if (running.load()) poll(fds, nfds, timeout_ms);
+}
@@ -0,0 +1,98 @@
+#ifndef SAMPLER_H
+#define SAMPLER_H
+
+#include <thread>
+#include <atomic>
+#include <array>
+#include <memory>
+#include <vector>
+#include <unordered_map>
+#include "System.h"
+#include "Snapshot.h"
+#include "Collector.h"
+#include "Quiet.h"
+#include "History.h"
+#include "ProcessHistory.h"
+#include "ProcessWindows.h"
+#include "Recording.h"
+
+// Runs the registered collectors on a background thread, each at its own
+// cadence and within its CPU budget, and publishes a Snapshot whenever any of
+// them ran. The UI thread only calls Acquire()/Current() and the setters below.
+// The thread sleeps on a CLOCK_MONOTONIC timerfd armed with the absolute
+// deadline of the next collector, so the cadence does not drift with how
+// long a pass took or with frame timing. Every published value of the
+// system-wide metrics is also appended to History(), which the thread
+// flushes once a second when it is backed by a file; every process in the
+// process table gets its CPU and RSS appended to ProcHistory() and folded
+// into the sliding windows of Windows().
+class Sampler {
+public:
+    explicit Sampler(float cpu_budget = CollectorRegistry::kDefaultTotalBudget,
+                     size_t history_budget = HistoryStore::kDefaultBudget,
+                     const std::string& history_path = std::string());
+    ~Sampler();
+    Sampler(const Sampler&) = delete;
+    Sampler& operator=(const Sampler&) = delete;
+
+    // Applied by the collector thread when it starts; call before Start()
+    void SetQuiet(const QuietConfig& config) { quiet_config = config; }
+    // Appends every published snapshot to a session recording; call before Start()
+    bool Record(const std::string& path, std::string& error) { return recorder.Open(path, error); }
+    const SessionRecorder& Recorder() const { return recorder; } // counters are written by the collector thread
+    // Replaces the per-process history pool; call before Start()
+    void SetProcessHistory(size_t budget_bytes, int64_t grace_ms) { proc_history.reset(new ProcessHistory(budget_bytes, grace_ms)); }
+    // What quiet mode actually achieved, once the thread has applied it
+    const QuietStatus* Quiet() const { return quiet_ready.load(std::memory_order_acquire) ? &quiet_status : nullptr; }
+
+    void Start();
+    void Stop();
+
+    bool Acquire() { return buffer.Acquire(); }
+    const Snapshot& Current() const { return buffer.Current(); }
+    const HistoryStore& History() const { return history; }
+    ProcessHistory& ProcHistory() { return *proc_history; } // non-const: reads count as views
+    const ProcessWindows& Windows() const { return windows; }
+
+    // collector is an index into Snapshot::cadence
+    void SetPeriod(int collector, float seconds) { registry.SetPeriod(collector, seconds); }
+    void SetSelectedPid(int pid) { selected_pid.store(pid, std::memory_order_relaxed); }
+    // Processes re-read per run of the process collector; 0 means unbounded
+    void SetSweepBudget(size_t max_pids, long max_us) { system.SetSweepBudget(max_pids, max_us); }
+    void SetSweepUring(bool on) { system.SetSweepUring(on); }
+
+private:
+    void Run();
+    void Publish();
+    void Record();
+    void SleepUntil(Scheduler::Clock::time_point deadline);
+
+    System system;
+    CollectorRegistry registry;
+    SnapshotBuffer buffer;
+    Snapshot work; // latest value of every section; only touched by the collector thread
+    Arena scratch; // collectors' transient data, rewound after every publish
+
+    HistoryStore history;
+    std::array<uint64_t, SECTION_COUNT> recorded{};  // section versions already in history
+    std::vector<int> fixed_series;                   // ids of the series in Sampler.cpp's table
+    std::vector<int> cpu_irq_series;                 // by CPU id, interrupt rate summed over sources
+    std::unordered_map<std::string, int> disk_series;
+    std::unique_ptr<ProcessHistory> proc_history;
+    ProcessWindows windows;
+    SessionRecorder recorder;
+    Scheduler::Clock::time_point next_flush{};
+
+    std::thread worker;
+    std::atomic<bool> running{false};
+    std::atomic<int> selected_pid{-1};
+
+    QuietConfig quiet_config;
+    QuietStatus quiet_status;             // written once by the collector thread
+    std::atomic<bool> quiet_ready{false};
+
+    int timer_fd = -1; // -1 if timerfd is unavailable: poll() timeouts are used instead
+    int wake_fd = -1;  // eventfd, cuts the sleep short on Stop()
+};
+
+#endif
@@ -0,0 +1,51 @@
+#include "Scheduler.h"
+#include <algorithm>
+
+int Scheduler::Add(const std::string& name, float period, int priority, std::function<void()> run) {
+    int id = (int)tasks.size();
+    tasks.emplace_back(new Task(name, period, priority, std::move(run)));
+    queue.push({Clock::now(), priority, id}); // everything runs once on the first pass
+    return id;
+}
+
+size_t Scheduler::RunDue(Clock::time_point now, Clock::time_point& next_deadline) {
+    // Collect everything that is due, then run by priority so a slow
+    // low-priority task never delays a fast gauge that came due with it
+    std::vector<Timer> due;
+    while (!queue.empty() && queue.top().deadline <= now) {
+        due.push_back(queue.top());
+        queue.pop();
+    }
+    std::sort(due.begin(), due.end(), [](const Timer& a, const Timer& b) {
+        if (a.priority != b.priority) return a.priority < b.priority;
+        return a.deadline < b.deadline;
+    });
+
+    for (const Timer& t : due) {
+        Task& task = *tasks[t.task];
+        Clock::time_point started = Clock::now();
+        task.run();
+
+        if (task.runs > 0) {
+            float interval = std::chrono::duration<float>(started - task.last_run).count();
+            if (interval > 0.0f) {
+                float hz = 1.0f / interval;
+                task.effective_hz = task.runs == 1 ? hz : task.effective_hz * 0.8f + hz * 0.2f;
+            }
+        }
+        task.last_run = started;
+        task.runs++;
+
+        // Re-arm from the old deadline so the cadence does not drift with run time.
+        // If that deadline has already passed, skip ahead instead of bursting to catch up.
+        auto period = std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<float>(task.period.load(std::memory_order_relaxed)));
+        Clock::time_point next = t.deadline + period;
+        Clock::time_point finished = Clock::now();
+        if (next <= finished) next = finished + period;
+        queue.push({next, task.priority, t.task});
+    }
+
+    next_deadline = queue.empty() ? now + std::chrono::seconds(1) : queue.top().deadline;
+    return due.size();
+}
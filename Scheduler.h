@@ -0,0 +1,59 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <vector>
+#include <string>
+#include <queue>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <functional>
+
+// Per-metric cadence: every task has its own period and priority, and the
+// next run of each task sits in one deadline-ordered timer queue.
+class Scheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Task {
+        std::string name;
+        std::atomic<float> period;   // seconds; may be changed from another thread
+        int priority;                // lower runs first when several tasks are due together
+        std::function<void()> run;
+
+        // Written by the scheduling thread only
+        Clock::time_point last_run;
+        float effective_hz = 0.0f;   // smoothed 1 / (time between actual runs)
+        unsigned long runs = 0;
+
+        Task(const std::string& name, float period, int priority, std::function<void()> run)
+            : name(name), period(period), priority(priority), run(std::move(run)) {}
+    };
+
+    // Tasks must all be added before the first RunDue(); returns the task id.
+    int Add(const std::string& name, float period, int priority, std::function<void()> run);
+
+    // Runs every task whose deadline has passed and re-arms it.
+    // Returns how many ran; next_deadline receives the earliest pending deadline.
+    size_t RunDue(Clock::time_point now, Clock::time_point& next_deadline);
+
+    size_t Count() const { return tasks.size(); }
+    const Task& Get(int id) const { return *tasks[id]; }
+    void SetPeriod(int id, float seconds) { tasks[id]->period.store(seconds, std::memory_order_relaxed); }
+
+private:
+    struct Timer {
+        Clock::time_point deadline;
+        int priority;
+        int task;
+        bool operator>(const Timer& o) const {
+            if (deadline != o.deadline) return deadline > o.deadline;
+            return priority > o.priority;
+        }
+    };
+
+    std::vector<std::unique_ptr<Task>> tasks;
+    std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>> queue;
+};
+
+#endif
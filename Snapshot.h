@@ -0,0 +1,109 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <vector>
+#include <string>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <utility>
+#include <chrono>
+#include <unordered_map>
+#include "Parser.h"
+#include "Process.h"
+#include "ProcessTable.h"
+#include "Sockets.h"
+#include "Descriptors.h"
+#include "Counters.h"
+#include "Interrupts.h"
+#include "Numa.h"
+#include "Sweep.h"
+#include "Overhead.h"
+
+// Parts of a Snapshot that are refreshed independently, one per scheduled collector
+enum SnapshotSection {
+    SECTION_CPU, SECTION_MEMORY, SECTION_NETWORK, SECTION_CONNECTIVITY, SECTION_BATTERY,
+    SECTION_DISKS, SECTION_PROCESSES, SECTION_SOCKETS, SECTION_FDS, SECTION_KERNEL,
+    SECTION_INTERRUPTS, SECTION_NUMA, SECTION_SELF, SECTION_COUNT
+};
+
+struct CadenceInfo {
+    std::string name;
+    float period;         // configured, seconds
+    float applied_period; // after the CPU budget governor; >= period
+    float effective_hz;   // measured
+    float cpu_ms;         // thread CPU time per run, smoothed
+    float wall_ms;        // wall time per run, smoothed
+    float budget_percent; // of one core
+    float used_percent;   // cpu_ms / applied_period, of one core
+    float allocs;         // heap allocations per run, smoothed
+    float read_syscalls;  // read-type syscalls per run, smoothed
+    float read_kb;        // bytes read per run, smoothed
+};
+
+// Everything one refresh of the dashboard shows. Filled by the collector
+// thread, then handed to the UI and never modified again.
+struct Snapshot {
+    uint64_t sequence = 0;
+    // Collector run each section came from. Lets the producer skip copying
+    // sections that did not change into a recycled slot.
+    std::array<uint64_t, SECTION_COUNT> versions{};
+    // Monotonic time each section was actually read at
+    std::array<std::chrono::steady_clock::time_point, SECTION_COUNT> sampled_at{};
+    std::vector<CadenceInfo> cadence;        // indexed by collector id
+    int selected_pid = -1;                   // UI selection when this was taken (drives per-process detail)
+
+    float cpu = 0.0f;
+    float mem = 0.0f;
+    std::pair<float, float> net = {0.0f, 0.0f};
+    bool online = false;
+    int battery = -1;
+    std::vector<Parser::DiskStats> disks;
+
+    ProcessTable procs;                      // order sorted by CPU, highest first
+    SweepStats sweep;                        // how much of procs was refreshed by the last run
+    std::vector<SocketInfo> sockets;
+    std::unordered_map<int, int> conn_count; // pid -> TCP sockets
+    std::vector<FdUsage> fds;                // sorted by fd growth rate
+    KernelActivity kernel = {};
+    IrqMatrix irq;
+    IrqMatrix softirq;
+    std::vector<NumaNode> numa;
+    NumaProcess numa_proc;                   // for the pid selected when this was taken
+    SelfUsage self;                          // the monitor's own cost
+};
+
+// --- TRIPLE BUFFER ---
+// Single producer, single consumer, no locks. The producer always owns one
+// slot, the consumer owns another, and the third sits in `middle` together
+// with a "fresh" bit. Both sides only ever exchange their slot index with
+// the middle one, so neither can see a slot the other is writing.
+class SnapshotBuffer {
+public:
+    // Producer side
+    Snapshot& WriteSlot() { return slots[back]; }
+    void Publish() {
+        int prev = middle.exchange(back | kFresh, std::memory_order_acq_rel);
+        back = prev & kIndexMask;
+    }
+
+    // Consumer side: swaps in the newest snapshot if there is one; returns true if it did
+    bool Acquire() {
+        if (!(middle.load(std::memory_order_relaxed) & kFresh)) return false;
+        int prev = middle.exchange(front, std::memory_order_acq_rel);
+        front = prev & kIndexMask;
+        return true;
+    }
+    const Snapshot& Current() const { return slots[front]; }
+
+private:
+    static const int kFresh = 4;
+    static const int kIndexMask = 3;
+
+    Snapshot slots[3];
+    std::atomic<int> middle{1};
+    int back = 0;  // producer only
+    int front = 2; // consumer only
+};
+
+#endif
@@ -0,0 +1,234 @@
+#include "Sockets.h"
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <linux/sock_diag.h>
+#include <linux/inet_diag.h>
+#include <linux/tcp.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <cstring>
+#include <cstdio>
+#include <unordered_set>
+#include <algorithm>
+
+// Known pids re-read per Collect() while some sockets are still unattributed.
+// New pids are always scanned in full; this only bounds the catch-up work.
+static const size_t kRescanBudget = 256;
+// Most Collect() calls to wait between passes that find nothing
+static const uint32_t kMaxRescanBackoff = 32;
+
+SocketCollector::SocketCollector() : recv_buf(64 * 1024) {
+    nl_fd = socket(AF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC, NETLINK_SOCK_DIAG);
+}
+
+SocketCollector::~SocketCollector() {
+    if (nl_fd >= 0) close(nl_fd);
+}
+
+bool SocketCollector::Dump(int family, std::vector<SocketInfo>& out) {
+    struct {
+        nlmsghdr nlh;
+        inet_diag_req_v2 req;
+    } msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.nlh.nlmsg_len = sizeof(msg);
+    msg.nlh.nlmsg_type = SOCK_DIAG_BY_FAMILY;
+    msg.nlh.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+    msg.req.sdiag_family = family;
+    msg.req.sdiag_protocol = IPPROTO_TCP;
+    msg.req.idiag_states = ~0U;
+    msg.req.idiag_ext = 1 << (INET_DIAG_INFO - 1);
+
+    sockaddr_nl kernel;
+    memset(&kernel, 0, sizeof(kernel));
+    kernel.nl_family = AF_NETLINK;
+    if (sendto(nl_fd, &msg, sizeof(msg), 0, (sockaddr*)&kernel, sizeof(kernel)) < 0) return false;
+
+    while (true) {
+        ssize_t len = recv(nl_fd, recv_buf.data(), recv_buf.size(), 0);
+        if (len <= 0) return false;
+
+        nlmsghdr* h = (nlmsghdr*)recv_buf.data();
+        for (; NLMSG_OK(h, len); h = NLMSG_NEXT(h, len)) {
+            if (h->nlmsg_type == NLMSG_DONE) return true;
+            if (h->nlmsg_type == NLMSG_ERROR) return false;
+
+            inet_diag_msg* d = (inet_diag_msg*)NLMSG_DATA(h);
+            SocketInfo s;
+            memset(&s, 0, sizeof(s));
+            s.family = d->idiag_family;
+            s.state = d->idiag_state;
+            memcpy(s.local_addr, d->id.idiag_src, sizeof(s.local_addr));
+            memcpy(s.remote_addr, d->id.idiag_dst, sizeof(s.remote_addr));
+            s.local_port = ntohs(d->id.idiag_sport);
+            s.remote_port = ntohs(d->id.idiag_dport);
+            s.inode = d->idiag_inode;
+            s.pid = -1;
+
+            int attr_len = h->nlmsg_len - NLMSG_LENGTH(sizeof(*d));
+            for (rtattr* a = (rtattr*)(d + 1); RTA_OK(a, attr_len); a = RTA_NEXT(a, attr_len)) {
+                if (a->rta_type != INET_DIAG_INFO) continue;
+                // Older kernels send a shorter tcp_info; missing fields stay zero
+                tcp_info info;
+                memset(&info, 0, sizeof(info));
+                memcpy(&info, RTA_DATA(a), std::min((size_t)RTA_PAYLOAD(a), sizeof(info)));
+                s.rtt_us = info.tcpi_rtt;
+                s.rtt_var_us = info.tcpi_rttvar;
+                s.retransmits = info.tcpi_total_retrans;
+                s.bytes_acked = info.tcpi_bytes_acked;
+                s.bytes_received = info.tcpi_bytes_received;
+            }
+            out.push_back(s);
+        }
+    }
+}
+
+void SocketCollector::ScanPid(const ProcessKey& key) {
+    char path[32];
+    snprintf(path, sizeof(path), "/proc/%d/fd", key.pid);
+    DIR* dir = opendir(path);
+    std::vector<uint32_t>& held = pid_inodes[key];
+    if (!dir) return; // exited or not ours to read; remembered as empty so we don't retry every tick
+
+    char link[64];
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != nullptr) {
+        if (entry->d_name[0] == '.') continue;
+        ssize_t n = readlinkat(dirfd(dir), entry->d_name, link, sizeof(link) - 1);
+        if (n <= 8 || strncmp(link, "socket:[", 8) != 0) continue;
+        link[n] = '\0';
+        uint32_t inode = (uint32_t)strtoul(link + 8, nullptr, 10);
+        inode_owner[inode] = key.pid;
+        held.push_back(inode);
+    }
+    closedir(dir);
+}
+
+void SocketCollector::ForgetPid(const ProcessKey& key) {
+    auto it = pid_inodes.find(key);
+    if (it == pid_inodes.end()) return;
+    for (uint32_t inode : it->second) {
+        auto owner = inode_owner.find(inode);
+        if (owner != inode_owner.end() && owner->second == key.pid) inode_owner.erase(owner);
+    }
+    pid_inodes.erase(it);
+}
+
+// Re-reads a known pid in place, so the map nodes of sockets it still holds are kept
+void SocketCollector::RescanPid(const ProcessKey& key, std::pmr::memory_resource* scratch) {
+    auto it = pid_inodes.find(key);
+    if (it == pid_inodes.end()) {
+        ScanPid(key);
+        return;
+    }
+    std::pmr::vector<uint32_t> before(it->second.begin(), it->second.end(), scratch);
+    it->second.clear();
+    ScanPid(key);
+    std::pmr::vector<uint32_t> after(it->second.begin(), it->second.end(), scratch);
+    std::sort(after.begin(), after.end());
+    for (uint32_t inode : before) {
+        if (std::binary_search(after.begin(), after.end(), inode)) continue;
+        auto owner = inode_owner.find(inode);
+        if (owner != inode_owner.end() && owner->second == key.pid) inode_owner.erase(owner);
+    }
+}
+
+void SocketCollector::Unowned(const std::vector<SocketInfo>& sockets, std::pmr::vector<uint32_t>& out) const {
+    out.clear();
+    for (const auto& s : sockets) {
+        if (s.inode != 0 && !inode_owner.count(s.inode)) out.push_back(s.inode);
+    }
+    std::sort(out.begin(), out.end());
+}
+
+void SocketCollector::RefreshIndex(const ProcessTable& procs, std::vector<SocketInfo>& sockets, std::pmr::memory_resource* scratch) {
+    // 1. Drop exited processes, including pids since reused by a new one
+    std::pmr::unordered_set<ProcessKey, ProcessKeyHash> alive(procs.Size() * 2, ProcessKeyHash(), std::equal_to<ProcessKey>(), scratch);
+    for (size_t i = 0; i < procs.Size(); ++i) alive.insert({procs.pid[i], procs.starttime[i]});
+    for (auto it = pid_inodes.begin(); it != pid_inodes.end();) {
+        if (alive.count(it->first)) { ++it; continue; }
+        ProcessKey dead = it->first;
+        ++it;
+        ForgetPid(dead);
+    }
+
+    // 2. Scan processes we have never seen
+    for (size_t i = 0; i < procs.Size(); ++i) {
+        ProcessKey key = {procs.pid[i], procs.starttime[i]};
+        if (!pid_inodes.count(key)) ScanPid(key);
+    }
+
+    // 3. Sockets opened by already-known processes: rescan a slice of them
+    // round-robin. Some are never found (kernel sockets, processes we may not
+    // read), so after a whole pass that found nothing the next one waits,
+    // twice as long each time, unless an unowned socket shows up that the
+    // last pass did not see
+    std::pmr::vector<uint32_t> unowned(scratch);
+    Unowned(sockets, unowned);
+    if (unowned.empty() || procs.Size() == 0) {
+        stale.clear();
+        pass_left = 0;
+        backoff = wait = 0;
+        return;
+    }
+    for (uint32_t inode : unowned) {
+        if (!std::binary_search(stale.begin(), stale.end(), inode)) {
+            wait = 0;
+            break;
+        }
+    }
+    if (wait > 0) {
+        wait--;
+        return;
+    }
+    if (pass_left == 0) {
+        pass_left = procs.Size();
+        pass_found = false;
+    }
+    size_t budget = std::min(kRescanBudget, pass_left);
+    for (size_t i = 0; i < budget; ++i) {
+        size_t row = rescan_cursor++ % procs.Size();
+        RescanPid({procs.pid[row], procs.starttime[row]}, scratch);
+    }
+    pass_left -= budget;
+    size_t before = unowned.size();
+    Unowned(sockets, unowned);
+    if (unowned.size() < before) pass_found = true;
+    if (pass_left > 0) return;
+    stale.assign(unowned.begin(), unowned.end());
+    backoff = pass_found ? 0 : std::min(std::max(backoff * 2, 1u), kMaxRescanBackoff);
+    wait = backoff;
+}
+
+void SocketCollector::Collect(const ProcessTable& procs, std::vector<SocketInfo>& sockets, std::pmr::memory_resource* scratch) {
+    sockets.clear();
+    if (nl_fd < 0) return;
+
+    Dump(AF_INET, sockets);
+    Dump(AF_INET6, sockets);
+
+    RefreshIndex(procs, sockets, scratch);
+    for (auto& s : sockets) {
+        auto owner = inode_owner.find(s.inode);
+        if (owner != inode_owner.end()) s.pid = owner->second;
+    }
+}
+
+std::string SocketCollector::FormatEndpoint(int family, const uint8_t* addr, uint16_t port) {
+    char buf[INET6_ADDRSTRLEN + 8];
+    if (!inet_ntop(family, addr, buf, INET6_ADDRSTRLEN)) return "?";
+    std::string out = (family == AF_INET6) ? "[" + std::string(buf) + "]" : std::string(buf);
+    return out + ":" + std::to_string(port);
+}
+
+const char* SocketCollector::StateName(int state) {
+    static const char* names[] = {
+        "?", "ESTAB", "SYN-SENT", "SYN-RECV", "FIN-WAIT-1", "FIN-WAIT-2", "TIME-WAIT",
+        "CLOSE", "CLOSE-WAIT", "LAST-ACK", "LISTEN", "CLOSING", "NEW-SYN-RECV"
+    };
+    if (state < 0 || state >= (int)(sizeof(names) / sizeof(names[0]))) return "?";
+    return names[state];
+}
@@ -0,0 +1,70 @@
+#ifndef SOCKETS_H
+#define SOCKETS_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <unordered_map>
+#include <memory_resource>
+#include "ProcessTable.h"
+
+// One TCP socket as reported by a NETLINK_SOCK_DIAG dump.
+// Addresses stay in raw network form; use FormatEndpoint() only for rows you display.
+struct SocketInfo {
+    int family;              // AF_INET or AF_INET6
+    int state;               // TCP_ESTABLISHED, TCP_LISTEN, ...
+    uint8_t local_addr[16];
+    uint8_t remote_addr[16];
+    uint16_t local_port;
+    uint16_t remote_port;
+    uint32_t inode;
+    int pid;                 // -1 if no owner was found (kernel sockets, other netns, no permission)
+
+    // INET_DIAG_INFO (struct tcp_info); zero when the kernel did not send it
+    uint32_t rtt_us;
+    uint32_t rtt_var_us;
+    uint32_t retransmits;    // tcpi_total_retrans
+    uint64_t bytes_acked;
+    uint64_t bytes_received;
+};
+
+class SocketCollector {
+public:
+    SocketCollector();
+    ~SocketCollector();
+    SocketCollector(const SocketCollector&) = delete;
+    SocketCollector& operator=(const SocketCollector&) = delete;
+
+    // Dumps all TCP sockets (v4 + v6) into `out` (reused) and attributes them
+    // to the processes in `procs`. Per-call lookups are built in `scratch`.
+    void Collect(const ProcessTable& procs, std::vector<SocketInfo>& out, std::pmr::memory_resource* scratch);
+
+    static std::string FormatEndpoint(int family, const uint8_t* addr, uint16_t port);
+    static const char* StateName(int state);
+
+private:
+    bool Dump(int family, std::vector<SocketInfo>& out);
+    void ScanPid(const ProcessKey& key);
+    void ForgetPid(const ProcessKey& key);
+    void RescanPid(const ProcessKey& key, std::pmr::memory_resource* scratch);
+    void RefreshIndex(const ProcessTable& procs, std::vector<SocketInfo>& sockets, std::pmr::memory_resource* scratch);
+    // Sorted inodes of the sockets no process is known to hold
+    void Unowned(const std::vector<SocketInfo>& sockets, std::pmr::vector<uint32_t>& out) const;
+
+    int nl_fd = -1;
+    std::vector<char> recv_buf;
+
+    // socket inode -> owning pid, built from /proc/PID/fd
+    std::unordered_map<uint32_t, int> inode_owner;
+    // process -> socket inodes it held at its last scan (so exits can be pruned);
+    // keyed with the start time so a reused pid is scanned afresh
+    std::unordered_map<ProcessKey, std::vector<uint32_t>, ProcessKeyHash> pid_inodes;
+    size_t rescan_cursor = 0;
+    size_t pass_left = 0;          // rescans until the current pass has covered every process
+    bool pass_found = false;       // the current pass attributed a socket
+    std::vector<uint32_t> stale;   // unowned inodes, sorted, as of the last full pass
+    uint32_t backoff = 0;          // calls to wait after the last full pass
+    uint32_t wait = 0;
+};
+
+#endif
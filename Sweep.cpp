@@ -0,0 +1,126 @@
+#include "Sweep.h"
+#include "Parser.h"
+#include <algorithm>
+#include <unordered_set>
+
+void ProcessSweep::Apply(Entry& e, const Parser::ProcStat* stat) {
+    if (e.proc.Update(stat)) {
+        e.interval = 1;
+        e.due = tick + 1;
+        return;
+    }
+    e.interval = std::min(e.interval * 2, kMaxBackoff);
+    // Spread by pid over the upper half of the interval, so daemons that went
+    // idle together do not all come due on the same tick
+    uint32_t half = e.interval / 2;
+    e.due = tick + half + (uint32_t)e.proc.pid % (half + 1);
+}
+
+void ProcessSweep::ReadChunk(const int* pids, size_t count, bool batched) {
+    auto apply = [this](int pid, const Parser::ProcStat* stat) {
+        auto it = table.find(pid);
+        if (it != table.end()) Apply(it->second, stat);
+        else if (stat) table.emplace(pid, Entry(pid, stat)).first->second.due = tick + 1; // new pids start hot
+    };
+
+    Parser::ProcStat& stat = stat_buf;
+    if (batched) {
+        for (size_t i = 0; i < count; ++i) {
+            size_t len = 0;
+            const char* text = uring->Data(i, len);
+            bool ok;
+            if (!text) ok = false;
+            else if (len >= UringReader::kBufSize) ok = Parser::ProcessStat(pids[i], stat); // did not fit
+            else ok = Parser::ParseProcessStat(text, len, stat);
+            apply(pids[i], ok ? &stat : nullptr);
+        }
+        return;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        apply(pids[i], Parser::ProcessStat(pids[i], stat) ? &stat : nullptr);
+    }
+}
+
+void ProcessSweep::Sweep(ProcessTable& out, SweepStats& stats, std::pmr::memory_resource* scratch) {
+    typedef std::chrono::steady_clock Clock;
+    Clock::time_point start = Clock::now();
+    size_t pid_budget = max_pids.load(std::memory_order_relaxed);
+    long us_budget = max_us.load(std::memory_order_relaxed);
+    if (pid_budget == 0) pid_budget = (size_t)-1;
+    Clock::time_point deadline = us_budget > 0 ? start + std::chrono::microseconds(us_budget) : Clock::time_point::max();
+
+    stats = SweepStats();
+    tick++;
+
+    // --- LIVE PIDS ---
+    // Listing /proc is the one cost that still scales with the process count,
+    // but it is a single getdents pass and far cheaper than reading each pid.
+    std::pmr::vector<int> pids = Parser::Pids(scratch);
+    std::pmr::unordered_set<int> live(pids.begin(), pids.end(), pids.size() * 2, std::hash<int>(), std::equal_to<int>(), scratch);
+    hot.clear();
+    idle.clear();
+    for (auto it = table.begin(); it != table.end();) {
+        if (!live.count(it->first)) {
+            it = table.erase(it);
+            continue;
+        }
+        const Entry& e = it->second;
+        if (e.due > tick) stats.backed_off++;
+        else if (e.interval == 1) hot.push_back(it->first);
+        else idle.emplace_back(e.due, it->first);
+        ++it;
+    }
+
+    // --- READ ORDER ---
+    // Processes that used CPU at their last read first, then never-seen pids
+    // (a fork storm shows up as soon as the budget allows), then due idle
+    // pids, most overdue first so the ones the budget skipped are not starved
+    order.assign(hot.begin(), hot.end());
+    for (int pid : pids) {
+        if (!table.count(pid)) order.push_back(pid);
+    }
+    std::sort(idle.begin(), idle.end());
+    for (const auto& due : idle) order.push_back(due.second);
+    if (order.size() > pid_budget) order.resize(pid_budget);
+
+    // --- READ ---
+    bool batched = use_uring.load(std::memory_order_relaxed);
+    if (batched && !uring) uring.reset(new UringReader());
+    size_t done = 0;
+    while (done < order.size() && Clock::now() < deadline) {
+        batched = batched && uring->Available();
+        size_t n = std::min(order.size() - done, batched ? UringReader::kBatch : (size_t)1);
+        if (batched && !uring->Read(&order[done], n, "stat")) continue; // ring gave up: redo this chunk with plain reads
+        ReadChunk(&order[done], n, batched);
+        done += n;
+    }
+    stats.uring = batched && done > 0;
+    stats.hot = std::min(done, hot.size());
+
+    // --- COMMANDS ---
+    // Exited processes leave their strings behind; rebuild the pool once
+    // those outnumber the live ones
+    bool compact = strings.Count() > 2 * table.size() + 1024;
+    if (compact) strings.Clear();
+    for (auto& kv : table) {
+        Entry& e = kv.second;
+        if (compact || e.command_version != e.proc.command_version) {
+            e.command = strings.Intern(e.proc.command);
+            e.command_version = e.proc.command_version;
+        }
+    }
+
+    Clock::time_point end = Clock::now();
+    out.Clear();
+    out.strings.assign(strings.Data().begin(), strings.Data().end());
+    out.pool_generation = strings.Generation();
+    Clock::time_point oldest = end;
+    for (const auto& kv : table) {
+        out.Append(kv.second.proc, kv.second.command);
+        if (kv.second.proc.sampled_at < oldest) oldest = kv.second.proc.sampled_at;
+    }
+    stats.known = table.size();
+    stats.sampled = done;
+    stats.tick_ms = std::chrono::duration<float, std::milli>(end - start).count();
+    stats.oldest_age_s = std::chrono::duration<float>(end - oldest).count();
+}
@@ -0,0 +1,81 @@
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include <vector>
+#include <atomic>
+#include <cstdint>
+#include <utility>
+#include <unordered_map>
+#include <memory>
+#include <memory_resource>
+#include "Process.h"
+#include "ProcessTable.h"
+#include "Uring.h"
+
+struct SweepStats {
+    size_t known = 0;         // live pids in the table
+    size_t sampled = 0;       // pids re-read this tick
+    size_t hot = 0;           // of which were active at their previous read
+    size_t backed_off = 0;    // idle pids not due this tick
+    bool uring = false;       // stat files were read in io_uring batches
+    float tick_ms = 0.0f;     // time spent this tick
+    float oldest_age_s = 0.0f;
+};
+
+// Bounded-latency, activity-adaptive process sweep. Keeps every pid's last
+// reading and, per tick, re-reads at most `max_pids` processes or `max_us`
+// microseconds worth. A process whose CPU time did not move since its last
+// read doubles its interval, up to kMaxBackoff ticks; any movement puts it
+// back in the hot set, read every tick. Within a tick: hot pids, then new
+// ones, then due idle ones, most overdue first. Rows not reached keep their
+// older data (see Process::sampled_at). When io_uring is usable, stat files
+// are read UringReader::kBatch at a time and the time budget is checked
+// between batches. Commands are interned once per exec, so filling the output
+// table copies only fixed-size columns and one string buffer.
+class ProcessSweep {
+public:
+    static constexpr size_t kDefaultMaxPids = 4096;
+    static constexpr long kDefaultMaxUs = 50000;
+    static constexpr uint32_t kMaxBackoff = 64; // ticks
+
+    // Thread-safe; 0 means unbounded
+    void SetBudget(size_t max_pids, long max_us) {
+        this->max_pids.store(max_pids, std::memory_order_relaxed);
+        this->max_us.store(max_us, std::memory_order_relaxed);
+    }
+    // Thread-safe; falls back to plain reads on its own when io_uring is unusable
+    void SetUseUring(bool on) { use_uring.store(on, std::memory_order_relaxed); }
+
+    // Refills `out` with every known process (rows unsorted, order empty).
+    // Per-tick lists are built in `scratch`; see Arena.
+    void Sweep(ProcessTable& out, SweepStats& stats, std::pmr::memory_resource* scratch);
+
+private:
+    struct Entry {
+        Process proc;
+        uint32_t interval = 1; // ticks between reads
+        uint64_t due = 0;      // tick of the next read
+        uint32_t command = 0;  // handle into strings, valid for command_version
+        uint32_t command_version = 0;
+
+        Entry(int pid, const Parser::ProcStat* stat) : proc(pid, stat) {}
+    };
+
+    void Apply(Entry& e, const Parser::ProcStat* stat);
+    void ReadChunk(const int* pids, size_t count, bool batched);
+
+    std::unordered_map<int, Entry> table;
+    StringPool strings;                          // commands of live and exited processes
+    std::vector<int> hot;                        // reused every tick
+    std::vector<std::pair<uint64_t, int>> idle;  // (due, pid), reused every tick
+    std::vector<int> order;                      // pids to read this tick, reused
+    Parser::ProcStat stat_buf;                   // reused so long kernel thread names keep their capacity
+    uint64_t tick = 0;
+    std::unique_ptr<UringReader> uring;          // created on first use
+
+    std::atomic<size_t> max_pids{kDefaultMaxPids};
+    std::atomic<long> max_us{kDefaultMaxUs};
+    std::atomic<bool> use_uring{false}; // opt-in: only a win where /proc opens are not punted to io-wq
+};
+
+#endif
@@ -3,20 +3,31 @@
 #include <signal.h> // Needed for sending signals
 
 float System::GetCpuUsage() {
-    return Parser::CpuUsage();
+    Parser::CpuTimes now = Parser::GetCpuTimes();
+    long long busy = now.busy - last_cpu.busy;
+    long long total = now.total - last_cpu.total;
+    last_cpu = now;
+    if (total <= 0) return 0.0f;
+    return 100.0f * busy / total;
 }
 
 float System::GetMemoryUsage() {
     return Parser::MemoryUsage();
 }
 
-std::pair<float, float> System::GetNetworkStats() {
-    Parser::NetStats current = Parser::GetNetworkTraffic();
+std::pair<float, float> System::GetNetworkStats(std::pmr::memory_resource* scratch) {
+    Parser::NetStats current = Parser::GetNetworkTraffic(scratch);
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    bool first = last_net_time.time_since_epoch().count() == 0;
+    float seconds = std::chrono::duration<float>(now - last_net_time).count();
     long rx_delta = current.rx_bytes - last_rx_bytes;
     long tx_delta = current.tx_bytes - last_tx_bytes;
     last_rx_bytes = current.rx_bytes;
     last_tx_bytes = current.tx_bytes;
-    return { (float)rx_delta / 1024.0f, (float)tx_delta / 1024.0f };
+    last_net_time = now;
+    // The collector cadence is configurable, so divide by the real interval
+    if (first || seconds <= 0.0f) return {0.0f, 0.0f};
+    return { (float)rx_delta / 1024.0f / seconds, (float)tx_delta / 1024.0f / seconds };
 }
 
 bool System::IsConnected() {
@@ -50,4 +61,32 @@ std::vector<Process> System::GetProcesses() {
         processes.push_back(proc);
     }
     return processes;
+}
+
+void System::SweepProcesses(ProcessTable& out, SweepStats& stats, std::pmr::memory_resource* scratch) {
+    sweep.Sweep(out, stats, scratch);
+}
+
+void System::GetSockets(const ProcessTable& procs, std::vector<SocketInfo>& out, std::pmr::memory_resource* scratch) {
+    sockets.Collect(procs, out, scratch);
+}
+
+void System::GetFdUsage(const ProcessTable& procs, std::vector<FdUsage>& out, std::pmr::memory_resource* scratch) {
+    descriptors.Collect(procs, out, scratch);
+}
+
+KernelActivity System::GetKernelActivity() {
+    return counters.Collect();
+}
+
+void System::GetInterrupts(IrqMatrix& hard, IrqMatrix& soft) {
+    interrupts.Collect(hard, soft);
+}
+
+std::vector<NumaNode> System::GetNumaNodes() {
+    return numa.Collect();
+}
+
+NumaProcess System::GetNumaProcess(int pid) {
+    return numa.CollectProcess(pid);
 }
\ No newline at end of file
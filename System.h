@@ -3,27 +3,52 @@
 
 #include <vector>
 #include <utility>
+#include <chrono>
 #include "Parser.h"
 #include "Process.h"
+#include "ProcessTable.h"
+#include "Sockets.h"
+#include "Descriptors.h"
+#include "Counters.h"
+#include "Interrupts.h"
+#include "Numa.h"
+#include "Sweep.h"
 
 class System {
 private:
     long last_rx_bytes = 0;
     long last_tx_bytes = 0;
+    Parser::CpuTimes last_cpu = {0, 0};
+    std::chrono::steady_clock::time_point last_net_time;
+    SocketCollector sockets;
+    FdCollector descriptors;
+    CounterCollector counters;
+    InterruptCollector interrupts;
+    NumaCollector numa;
+    ProcessSweep sweep;
 
 public:
-    float GetCpuUsage();
+    float GetCpuUsage(); // busy share of the ticks since the previous call (since boot on the first)
     float GetMemoryUsage();
-    std::pair<float, float> GetNetworkStats();
+    std::pair<float, float> GetNetworkStats(std::pmr::memory_resource* scratch = std::pmr::get_default_resource()); // KB/s over the time since the previous call
     bool IsConnected(); 
     int GetBattery(); 
     
     // --- PROCESS CONTROL ---
-    void TerminateProcess(int pid); // Polite close
-    void KillProcess(int pid);      // Force close
+    static void TerminateProcess(int pid); // Polite close
+    static void KillProcess(int pid);      // Force close
     
     std::vector<Parser::DiskStats> GetDisks(); 
     std::vector<Process> GetProcesses();
+    void SweepProcesses(ProcessTable& out, SweepStats& stats, std::pmr::memory_resource* scratch); // bounded per call, see ProcessSweep
+    void SetSweepBudget(size_t max_pids, long max_us) { sweep.SetBudget(max_pids, max_us); }
+    void SetSweepUring(bool on) { sweep.SetUseUring(on); }
+    void GetSockets(const ProcessTable& procs, std::vector<SocketInfo>& out, std::pmr::memory_resource* scratch);  // refills out in place
+    void GetFdUsage(const ProcessTable& procs, std::vector<FdUsage>& out, std::pmr::memory_resource* scratch);
+    KernelActivity GetKernelActivity();
+    void GetInterrupts(IrqMatrix& hard, IrqMatrix& soft); // updates in place to reuse row labels
+    std::vector<NumaNode> GetNumaNodes();
+    NumaProcess GetNumaProcess(int pid);
 };
 
 #endif
\ No newline at end of file
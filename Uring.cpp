@@ -0,0 +1,199 @@
+#include "Uring.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+
+// Longest "/proc/<pid>/<file>" we build
+static const size_t kPathLen = 48;
+
+#if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter) && defined(__NR_io_uring_register)
+static int SysSetup(unsigned entries, io_uring_params* p) {
+    return (int)syscall(__NR_io_uring_setup, entries, p);
+}
+static int SysEnter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+    return (int)syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0);
+}
+static int SysRegister(int fd, unsigned op, const void* arg, unsigned nr) {
+    return (int)syscall(__NR_io_uring_register, fd, op, arg, nr);
+}
+#else
+static int SysSetup(unsigned, io_uring_params*) { errno = ENOSYS; return -1; }
+static int SysEnter(int, unsigned, unsigned, unsigned) { errno = ENOSYS; return -1; }
+static int SysRegister(int, unsigned, const void*, unsigned) { errno = ENOSYS; return -1; }
+#endif
+
+UringReader::UringReader() {
+    if (!Setup()) Teardown();
+}
+
+UringReader::~UringReader() {
+    Teardown();
+}
+
+bool UringReader::Setup() {
+    io_uring_params p;
+    memset(&p, 0, sizeof(p));
+    ring_fd = SysSetup(kBatch * 3, &p);
+    if (ring_fd < 0) return false;
+
+    // --- RINGS ---
+    sq_size = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    cq_size = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+    bool single = p.features & IORING_FEAT_SINGLE_MMAP;
+    if (single) sq_size = cq_size = sq_size > cq_size ? sq_size : cq_size;
+
+    sq_ptr = mmap(nullptr, sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQ_RING);
+    if (sq_ptr == MAP_FAILED) { sq_ptr = nullptr; return false; }
+    if (single) {
+        cq_ptr = sq_ptr;
+    } else {
+        cq_ptr = mmap(nullptr, cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_CQ_RING);
+        if (cq_ptr == MAP_FAILED) { cq_ptr = nullptr; return false; }
+    }
+    sqes_size = p.sq_entries * sizeof(io_uring_sqe);
+    sqes_ptr = mmap(nullptr, sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQES);
+    if (sqes_ptr == MAP_FAILED) { sqes_ptr = nullptr; return false; }
+
+    char* sq = (char*)sq_ptr;
+    sq_tail = (unsigned*)(sq + p.sq_off.tail);
+    sq_mask = (unsigned*)(sq + p.sq_off.ring_mask);
+    sq_array = (unsigned*)(sq + p.sq_off.array);
+    char* cq = (char*)cq_ptr;
+    cq_head = (unsigned*)(cq + p.cq_off.head);
+    cq_tail = (unsigned*)(cq + p.cq_off.tail);
+    cq_mask = (unsigned*)(cq + p.cq_off.ring_mask);
+    cqes = cq + p.cq_off.cqes;
+
+    // --- PROBE ---
+    // Direct descriptors (openat/close on a fixed-file slot) arrived in 5.15
+    // without an op of their own. Older kernels would silently ignore the slot
+    // and close fd 0 instead, so require an op from the same release.
+    std::vector<char> probe_mem(sizeof(io_uring_probe) + 256 * sizeof(io_uring_probe_op), 0);
+    io_uring_probe* probe = (io_uring_probe*)probe_mem.data();
+    if (SysRegister(ring_fd, IORING_REGISTER_PROBE, probe, 256) < 0) return false;
+    const int needed[] = {IORING_OP_OPENAT, IORING_OP_READ_FIXED, IORING_OP_CLOSE, IORING_OP_MKDIRAT};
+    for (int op : needed) {
+        if (op > probe->last_op || !(probe->ops[op].flags & IO_URING_OP_SUPPORTED)) return false;
+    }
+
+    // --- REGISTERED BUFFERS AND FILE SLOTS ---
+    buffers.assign(kBatch * kBufSize, 0);
+    paths.assign(kBatch * kPathLen, 0);
+    results.assign(kBatch, -ECANCELED);
+    std::vector<iovec> iov(kBatch);
+    for (size_t i = 0; i < kBatch; ++i) {
+        iov[i].iov_base = &buffers[i * kBufSize];
+        iov[i].iov_len = kBufSize;
+    }
+    if (SysRegister(ring_fd, IORING_REGISTER_BUFFERS, iov.data(), kBatch) < 0) return false;
+    std::vector<int> slots(kBatch, -1); // sparse: filled by openat, emptied by close
+    if (SysRegister(ring_fd, IORING_REGISTER_FILES, slots.data(), kBatch) < 0) return false;
+    return true;
+}
+
+void UringReader::Teardown() {
+    if (sqes_ptr) munmap(sqes_ptr, sqes_size);
+    if (cq_ptr && cq_ptr != sq_ptr) munmap(cq_ptr, cq_size);
+    if (sq_ptr) munmap(sq_ptr, sq_size);
+    sqes_ptr = cq_ptr = sq_ptr = nullptr;
+    if (ring_fd >= 0) close(ring_fd);
+    ring_fd = -1;
+}
+
+bool UringReader::Read(const int* pids, size_t count, const char* file) {
+    if (!Available() || count > kBatch) return false;
+    if (count == 0) return true;
+
+    // --- QUEUE ---
+    // One openat -> read -> close chain per pid. The read is hard-linked so the
+    // close still runs (and frees the slot) when the read fails.
+    io_uring_sqe* sqes_base = (io_uring_sqe*)sqes_ptr;
+    unsigned mask = *sq_mask;
+    unsigned tail = *sq_tail;
+    auto next_sqe = [&]() {
+        unsigned index = tail & mask;
+        sq_array[index] = index;
+        tail++;
+        io_uring_sqe* sqe = &sqes_base[index];
+        memset(sqe, 0, sizeof(*sqe));
+        return sqe;
+    };
+    for (size_t i = 0; i < count; ++i) {
+        char* path = &paths[i * kPathLen];
+        snprintf(path, kPathLen, "/proc/%d/%s", pids[i], file);
+        results[i] = -ECANCELED;
+
+        io_uring_sqe* open = next_sqe();
+        open->opcode = IORING_OP_OPENAT;
+        open->fd = AT_FDCWD;
+        open->addr = (uint64_t)(uintptr_t)path;
+        open->open_flags = O_RDONLY; // no O_CLOEXEC: the kernel rejects it for direct descriptors
+        open->file_index = (uint32_t)i + 1; // 1-based slot; 0 would mean a normal fd
+        open->flags = IOSQE_IO_LINK;
+        open->user_data = i * 3;
+
+        io_uring_sqe* read = next_sqe();
+        read->opcode = IORING_OP_READ_FIXED;
+        read->fd = (int)i;
+        read->addr = (uint64_t)(uintptr_t)&buffers[i * kBufSize];
+        read->len = kBufSize;
+        read->off = 0;
+        read->buf_index = (uint16_t)i;
+        read->flags = IOSQE_FIXED_FILE | IOSQE_IO_HARDLINK;
+        read->user_data = i * 3 + 1;
+
+        io_uring_sqe* close = next_sqe();
+        close->opcode = IORING_OP_CLOSE;
+        close->file_index = (uint32_t)i + 1;
+        close->user_data = i * 3 + 2;
+    }
+    __atomic_store_n(sq_tail, tail, __ATOMIC_RELEASE);
+
+    // --- SUBMIT AND REAP ---
+    unsigned total = (unsigned)count * 3;
+    unsigned to_submit = total;
+    unsigned seen = 0;
+    bool unsupported = false;
+    const io_uring_cqe* cqe_base = (const io_uring_cqe*)cqes;
+    while (seen < total) {
+        int r = SysEnter(ring_fd, to_submit, total - seen, IORING_ENTER_GETEVENTS);
+        if (r < 0) {
+            if (errno == EINTR) continue;
+            Teardown();
+            return false;
+        }
+        to_submit -= (unsigned)r < to_submit ? (unsigned)r : to_submit;
+
+        unsigned head = *cq_head;
+        unsigned ready = __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE);
+        for (; head != ready; ++head, ++seen) {
+            const io_uring_cqe& cqe = cqe_base[head & *cq_mask];
+            size_t i = cqe.user_data / 3;
+            switch (cqe.user_data % 3) {
+                case 0: if (cqe.res == -EINVAL) unsupported = true; break;
+                case 1: results[i] = cqe.res; break;
+                default: break;
+            }
+        }
+        __atomic_store_n(cq_head, head, __ATOMIC_RELEASE);
+    }
+
+    if (unsupported) {
+        Teardown();
+        return false;
+    }
+    return true;
+}
+
+const char* UringReader::Data(size_t i, size_t& len) const {
+    if (i >= results.size() || results[i] < 0) return nullptr;
+    len = (size_t)results[i];
+    return &buffers[i * kBufSize];
+}
@@ -0,0 +1,59 @@
+#ifndef URING_H
+#define URING_H
+
+#include <vector>
+#include <cstddef>
+
+// Batched /proc reads over io_uring, without liburing. For each pid in a
+// batch it queues a linked openat -> read -> close chain on a fixed-file slot,
+// reading into a registered buffer, and submits the whole batch with one
+// io_uring_enter(). Needs direct descriptors (Linux 5.15+); anything older,
+// or io_uring being disabled, leaves Available() false and callers use
+// plain read()s instead.
+class UringReader {
+public:
+    static constexpr size_t kBatch = 256;     // pids per io_uring_enter
+    static constexpr size_t kBufSize = 1024;  // per pid; a full buffer means the file was truncated
+
+    UringReader();
+    ~UringReader();
+    UringReader(const UringReader&) = delete;
+    UringReader& operator=(const UringReader&) = delete;
+
+    bool Available() const { return ring_fd >= 0; }
+
+    // Reads /proc/<pid>/<file> for up to kBatch pids. Returns false if the
+    // ring is unusable (and then stays unavailable); individual failures show
+    // up as Data() returning nullptr.
+    bool Read(const int* pids, size_t count, const char* file);
+
+    // Result of entry i of the last Read(); valid until the next Read()
+    const char* Data(size_t i, size_t& len) const;
+
+private:
+    bool Setup();
+    void Teardown();
+
+    int ring_fd = -1;
+
+    // Mapped rings
+    void* sq_ptr = nullptr;
+    size_t sq_size = 0;
+    void* cq_ptr = nullptr;
+    size_t cq_size = 0;
+    void* sqes_ptr = nullptr;
+    size_t sqes_size = 0;
+    unsigned* sq_tail = nullptr;
+    unsigned* sq_mask = nullptr;
+    unsigned* sq_array = nullptr;
+    unsigned* cq_head = nullptr;
+    unsigned* cq_tail = nullptr;
+    unsigned* cq_mask = nullptr;
+    void* cqes = nullptr;
+
+    std::vector<char> buffers;   // kBatch * kBufSize, registered
+    std::vector<char> paths;     // kBatch NUL-terminated paths
+    std::vector<int> results;    // bytes read per entry, or -errno
+};
+
+#endif
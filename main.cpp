@@ -4,56 +4,356 @@
 #include <vector>
 #include <algorithm>
 #include <iomanip>
+#include <cstring>
 #include "System.h"
 #include "Process.h"
+#include "ProcessTable.h"
+#include "Uring.h"
+#include "Quiet.h"
+#include "Overhead.h"
+#include "Diff.h"
+#include "Arena.h"
+#include "Gorilla.h"
+#include "Columnar.h"
+#include "ProcessWindows.h"
+#include <random>
+#include <cmath>
+
+// --bench: time reading and parsing every /proc/PID/stat, plain reads vs io_uring batches
+static int RunBench(int rounds) {
+    std::vector<int> pids = Parser::Pids();
+    Parser::ProcStat stat;
+    size_t parsed = 0;
+
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        for (int pid : pids) parsed += Parser::ProcessStat(pid, stat);
+    }
+    std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+
+    UringReader uring;
+    bool available = uring.Available();
+    for (int r = 0; r < rounds && available; ++r) {
+        for (size_t i = 0; i < pids.size() && available; i += UringReader::kBatch) {
+            size_t n = std::min(pids.size() - i, UringReader::kBatch);
+            available = uring.Read(&pids[i], n, "stat");
+            for (size_t j = 0; j < n && available; ++j) {
+                size_t len = 0;
+                const char* text = uring.Data(j, len);
+                if (text) parsed += Parser::ParseProcessStat(text, len, stat);
+            }
+        }
+    }
+    std::chrono::steady_clock::time_point t2 = std::chrono::steady_clock::now();
+
+    double sync_ms = std::chrono::duration<double, std::milli>(t1 - t0).count() / rounds;
+    double uring_ms = std::chrono::duration<double, std::milli>(t2 - t1).count() / rounds;
+    std::cout << "{\"pids\": " << pids.size() << ",";
+    std::cout << "\"rounds\": " << rounds << ",";
+    std::cout << "\"sync_ms\": " << std::fixed << std::setprecision(3) << sync_ms << ",";
+    std::cout << "\"uring\": " << (available ? "true" : "false") << ",";
+    std::cout << "\"uring_ms\": " << (available ? uring_ms : 0.0) << ",";
+    std::cout << "\"parsed\": " << parsed << "}" << std::endl;
+    return 0;
+}
+
+// --bench-history: compressed size and codec speed on series shaped like the ones the Sampler records
+static int RunHistoryBench(size_t samples) {
+    struct Shape {
+        const char* name;
+        int period_ms;
+    };
+    const Shape shapes[] = {
+        {"cpu", 100},           // busy/total tick ratio of 8 CPUs over 100 ms
+        {"mem", 500},           // used share of MemTotal, drifts slowly
+        {"net.rx_kbs", 100},    // mostly idle with bursts, over measured intervals
+        {"kernel.procs_running", 1000},
+        {"self.rss_mb", 1000},  // flat
+    };
+    std::mt19937 rng(42);
+    std::vector<std::pair<int64_t, float>> input(samples);
+    std::vector<HistoryChunk> chunks;
+
+    for (const Shape& shape : shapes) {
+        // Timer wakeups land within a millisecond or two of the deadline
+        int64_t t = 1700000000000LL;
+        float mem = 41.3f;
+        for (size_t i = 0; i < samples; ++i) {
+            t += shape.period_ms + (int)(rng() % 3) - 1;
+            float v = 0.0f;
+            if (shape.name[0] == 'c') v = 100.0f * (rng() % 80) / 80.0f;
+            else if (shape.name[0] == 'm') v = (mem += (rng() % 10 == 0) ? ((int)(rng() % 200) - 100) * 0.0013f : 0.0f);
+            else if (shape.name[0] == 'n') v = (rng() % 10 < 7) ? 0.0f : (rng() % 150000) / 1024.0f / (0.1f + (rng() % 3 - 1) * 0.001f);
+            else if (shape.name[0] == 'k') v = (float)(1 + rng() % 4);
+            else v = 3.85f;
+            input[i] = {t, v};
+        }
+
+        std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+        chunks.assign(1, HistoryChunk());
+        ChunkEncoder encoder;
+        encoder.Start(chunks.back());
+        for (const auto& s : input) {
+            if (encoder.Append(s.first, s.second)) continue;
+            chunks.push_back(HistoryChunk());
+            encoder.Start(chunks.back());
+            encoder.Append(s.first, s.second);
+        }
+        std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+        size_t decoded = 0;
+        double checksum = 0.0;
+        for (const HistoryChunk& c : chunks) {
+            ChunkDecoder decoder(c);
+            int64_t ts;
+            float v;
+            while (decoder.Next(ts, v)) {
+                checksum += v;
+                decoded++;
+            }
+        }
+        std::chrono::steady_clock::time_point t2 = std::chrono::steady_clock::now();
+
+        size_t bits = 0;
+        for (const HistoryChunk& c : chunks) bits += c.bits;
+        double encode_s = std::chrono::duration<double>(t1 - t0).count();
+        double decode_s = std::chrono::duration<double>(t2 - t1).count();
+        std::cout << "{\"series\": \"" << shape.name << "\",";
+        std::cout << "\"samples\": " << decoded << ",";
+        std::cout << std::fixed << std::setprecision(2);
+        std::cout << "\"bytes_per_sample\": " << bits / 8.0 / samples << ",";
+        std::cout << "\"chunk_bytes_per_sample\": " << (double)chunks.size() * sizeof(HistoryChunk) / samples << ",";
+        std::cout << "\"raw_bytes_per_sample\": " << sizeof(int64_t) + sizeof(float) << ",";
+        std::cout << "\"encode_ns\": " << encode_s * 1e9 / samples << ",";
+        std::cout << "\"decode_msamples_per_s\": " << samples / decode_s / 1e6 << ",";
+        std::cout << "\"checksum\": " << checksum << "}" << std::endl;
+    }
+    return 0;
+}
+
+// --export: a recording or history file as a column file (see Columnar.h)
+static int RunExport(const char* in, const char* out) {
+    std::string error;
+    uint64_t rows = 0;
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    if (!Columnar::Export(in, out, error, rows)) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    std::cout << "{\"rows\": " << rows << ",\"seconds\": " << std::fixed << std::setprecision(3) << seconds << "}" << std::endl;
+    return 0;
+}
+
+// --columns: the schema of a column file, one line per column
+static int RunColumns(const char* path) {
+    static const char* const kTypes[] = {"", "int64", "int32", "float32", "uint8", "dict"};
+    ColumnFile file;
+    std::string error;
+    if (!file.Open(path, error)) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+    for (const ColumnFile::Info& c : file.Columns()) {
+        std::cout << "{\"name\": \"" << c.name << "\",\"type\": \"" << kTypes[c.type] << "\",\"rows\": " << c.rows;
+        if (c.type == COLUMN_DICT) std::cout << ",\"strings\": " << c.dict_count;
+        std::cout << "}" << std::endl;
+    }
+    return 0;
+}
+
+// cmdline separates arguments with NULs; those become spaces, and quotes,
+// backslashes and control characters are escaped
+static void WriteString(const char* text) {
+    std::cout << "\"";
+    for (; *text; ++text) {
+        char c = *text;
+        if (c == '"' || c == '\\') std::cout << '\\' << c;
+        else if ((unsigned char)c < 0x20) std::cout << "\\u" << std::hex << std::setw(4) << std::setfill('0') << (int)c << std::dec << std::setfill(' ');
+        else std::cout << c;
+    }
+    std::cout << "\"";
+}
+
+static void WriteProcess(const ProcessTable& table, size_t row) {
+    // Simple manual JSON formatting
+    std::cout << "{";
+    std::cout << "\"pid\": " << table.pid[row] << ",";
+    std::cout << "\"cpu\": " << table.cpu[row] << ",";
+    std::cout << "\"mem\": " << table.rss_mb[row] << ",";
+    std::cout << "\"command\": ";
+    WriteString(table.Command(row));
+    std::cout << "}";
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1 && strcmp(argv[1], "--bench") == 0) return RunBench(argc > 2 ? atoi(argv[2]) : 20);
+    if (argc > 1 && strcmp(argv[1], "--bench-history") == 0) return RunHistoryBench(argc > 2 ? (size_t)atol(argv[2]) : 1000000);
+    if (argc == 4 && strcmp(argv[1], "--export") == 0) return RunExport(argv[2], argv[3]);
+    if (argc == 3 && strcmp(argv[1], "--columns") == 0) return RunColumns(argv[2]);
+
+    // Everything here runs on the main thread, so quiet mode applies to it directly
+    QuietConfig quiet_config;
+    std::string arg_error;
+    if (!Quiet::ParseArgs(argc, argv, quiet_config, arg_error)) {
+        std::cerr << arg_error << "\nOptions:\n  --bench [rounds]   compare plain and io_uring stat reads\n"
+                  << "  --bench-history [samples]  history compression ratio and codec speed\n"
+                  << "  --export IN OUT    write a recording or history file as columns (see Columnar.h)\n"
+                  << "  --columns FILE     list the columns of an exported file\n"
+                  << "  --delta            stream added/removed/changed processes instead of the top 20\n"
+                  << "  --top=AGG:S        add the top 10 by AGG (avg_cpu, max_cpu, avg_rss, max_rss) over the last S (60, 300, 3600) seconds\n"
+                  << Quiet::Usage();
+        return 2;
+    }
+    bool delta = false;
+    int top_window = -1;  // index into ProcessWindows::kWindowMs; -1: no windowed ranking
+    WindowAggregate top_aggregate = WINDOW_AVG_CPU;
+    for (int i = 1; i < argc; ++i) {
+        delta |= strcmp(argv[i], "--delta") == 0;
+        if (strncmp(argv[i], "--top=", 6) != 0) continue;
+        // --top=AGGREGATE:SECONDS, e.g. --top=avg_cpu:300
+        const char* arg = argv[i] + 6;
+        const char* colon = strchr(arg, ':');
+        std::string name(arg, colon ? colon : arg + strlen(arg));
+        long seconds = colon ? atol(colon + 1) : 0;
+        for (int a = 0; a < WINDOW_AGGREGATE_COUNT; ++a) {
+            if (name == ProcessWindows::AggregateName((WindowAggregate)a)) top_aggregate = (WindowAggregate)a;
+        }
+        for (int w = 0; w < ProcessWindows::kWindows; ++w) {
+            if (seconds * 1000 == ProcessWindows::kWindowMs[w]) top_window = w;
+        }
+        if (top_window < 0 || name != ProcessWindows::AggregateName(top_aggregate)) {
+            std::cerr << "--top expects avg_cpu, max_cpu, avg_rss or max_rss, then :60, :300 or :3600 seconds" << std::endl;
+            return 2;
+        }
+    }
+    ProcessDiffer differ(0.05f);
+    QuietStatus quiet = Quiet::Apply(quiet_config);
+    if (!quiet.errors.empty()) std::cerr << "quiet mode partly applied: " << quiet.errors << std::endl;
 
-int main() {
     System system;
+    IoMonitor self_io(false); // this thread does all the collecting
+    system.SetSweepBudget(0, 0); // one line per second: read every process that is due
+    SweepStats sweep;
+    ProcessTable processes; // refilled in place every pass
+    ProcessWindows windows;
+    std::vector<WindowRank> top;
+    Arena scratch;          // transient data of one pass
+
+    // Absolute deadlines, so the interval does not stretch by the time each pass takes
+    std::chrono::steady_clock::time_point next = std::chrono::steady_clock::now();
 
     while (true) {
-        // 1. Get Data
+        double cpu0 = Overhead::ThreadCpuSeconds();
+        uint64_t allocs0 = Overhead::ThreadAllocations();
+        IoCounters io0 = self_io.Read();
+
+        // 1. Get Data (rates are over the measured time since the previous pass)
+        auto timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
         float cpuUsage = system.GetCpuUsage();
         float memUsage = system.GetMemoryUsage();
-        std::vector<Process> processes = system.GetProcesses();
+        KernelActivity kernel = system.GetKernelActivity();
+        system.SweepProcesses(processes, sweep, scratch.Resource());
+        if (top_window >= 0) windows.Update(processes, std::chrono::steady_clock::now(), timestamp);
 
-        // 2. Sort Processes (High CPU first)
-        std::sort(processes.begin(), processes.end(), [](const Process& a, const Process& b) {
-            return a.cpuUsage > b.cpuUsage;
-        });
+        // 2. Sort Processes (High CPU first); the delta stream has no order to keep
+        if (!delta) processes.SortByCpu();
+
+        // What collecting this pass cost (the output below is not included)
+        IoCounters io1 = self_io.Read();
+        double cpu_ms = (Overhead::ThreadCpuSeconds() - cpu0) * 1000.0;
+        uint64_t allocs = Overhead::ThreadAllocations() - allocs0;
 
         // 3. Construct JSON manually (avoiding external dependencies for now)
         std::cout << "{";
+        std::cout << "\"timestamp_ms\": " << timestamp << ",";
+        std::cout << "\"quiet\": " << (quiet.enabled ? "true" : "false") << ",";
+        std::cout << "\"self\": {";
+        std::cout << "\"cpu_ms\": " << std::fixed << std::setprecision(3) << cpu_ms << ",";
+        std::cout << "\"read_syscalls\": " << (io1.syscalls - io0.syscalls) << ",";
+        std::cout << "\"read_bytes\": " << (io1.bytes - io0.bytes) << ",";
+        std::cout << "\"allocs\": " << allocs << ",";
+        std::cout << "\"rss_kb\": " << Overhead::RssKb();
+        std::cout << "},";
         std::cout << "\"cpu\": " << std::fixed << std::setprecision(2) << cpuUsage << ",";
         std::cout << "\"memory\": " << std::fixed << std::setprecision(2) << memUsage << ",";
-        std::cout << "\"processes\": [";
-
-        // Limit to top 20 processes to keep the data stream light
-        int limit = 20;
-        for (size_t i = 0; i < processes.size() && i < limit; ++i) {
-            const auto& proc = processes[i];
-            
-            // Simple manual JSON formatting
-            std::cout << "{";
-            std::cout << "\"pid\": " << proc.pid << ",";
-            std::cout << "\"cpu\": " << proc.cpuUsage << ",";
-            std::cout << "\"mem\": " << proc.memoryUsage << ",";
-            // Sanitize command string (basic) to avoid breaking JSON with quotes
-            std::string cmd = proc.command; 
-            // Very basic escape for quotes could be added here if needed
-            std::cout << "\"command\": \"" << cmd << "\""; 
-            std::cout << "}";
-
-            if (i < processes.size() - 1 && i < limit - 1) {
-                std::cout << ",";
+        std::cout << "\"kernel\": {";
+        std::cout << "\"pgfault\": " << kernel.pgfault << ",";
+        std::cout << "\"pgmajfault\": " << kernel.pgmajfault << ",";
+        std::cout << "\"pswpin\": " << kernel.pswpin << ",";
+        std::cout << "\"pswpout\": " << kernel.pswpout << ",";
+        std::cout << "\"pgscan\": " << kernel.pgscan << ",";
+        std::cout << "\"pgsteal\": " << kernel.pgsteal << ",";
+        std::cout << "\"oom_kill\": " << kernel.oom_kill << ",";
+        std::cout << "\"ctxt\": " << kernel.ctxt << ",";
+        std::cout << "\"intr\": " << kernel.intr << ",";
+        std::cout << "\"forks\": " << kernel.forks << ",";
+        std::cout << "\"procs_running\": " << kernel.procs_running << ",";
+        std::cout << "\"procs_blocked\": " << kernel.procs_blocked;
+        std::cout << "},";
+        if (delta) {
+            // Only what changed since the previous line; the first line adds everything
+            const ProcessDiff& diff = differ.Update(processes);
+            std::cout << "\"added\": [";
+            for (size_t i = 0; i < diff.added.size(); ++i) {
+                if (i > 0) std::cout << ",";
+                WriteProcess(processes, diff.added[i]);
+            }
+            std::cout << "],\"removed\": [";
+            for (size_t i = 0; i < diff.removed.size(); ++i) {
+                if (i > 0) std::cout << ",";
+                std::cout << diff.removed[i];
+            }
+            std::cout << "],\"changed\": [";
+            for (size_t i = 0; i < diff.changed.size(); ++i) {
+                const ProcessChange& change = diff.changed[i];
+                size_t row = change.index;
+                if (i > 0) std::cout << ",";
+                std::cout << "{\"pid\": " << processes.pid[row];
+                if (change.dirty & FIELD_CPU) std::cout << ",\"cpu\": " << processes.cpu[row];
+                if (change.dirty & FIELD_MEMORY) std::cout << ",\"mem\": " << processes.rss_mb[row];
+                if (change.dirty & FIELD_COMMAND) {
+                    std::cout << ",\"command\": ";
+                    WriteString(processes.Command(row));
+                }
+                std::cout << "}";
+            }
+            std::cout << "]";
+        } else {
+            std::cout << "\"processes\": [";
+
+            // Limit to top 20 processes to keep the data stream light
+            size_t limit = 20;
+            for (size_t i = 0; i < processes.order.size() && i < limit; ++i) {
+                if (i > 0) std::cout << ",";
+                WriteProcess(processes, processes.order[i]);
+            }
+
+            std::cout << "]";
+        }
+        if (top_window >= 0) {
+            // Ranked from the windows' running aggregates; exited processes stay until they age out
+            windows.Top(top_window, top_aggregate, 10, top);
+            std::cout << ",\"top\": {\"aggregate\": \"" << ProcessWindows::AggregateName(top_aggregate) << "\",";
+            std::cout << "\"window_s\": " << ProcessWindows::kWindowMs[top_window] / 1000 << ",\"processes\": [";
+            for (size_t i = 0; i < top.size(); ++i) {
+                if (i > 0) std::cout << ",";
+                std::cout << "{\"pid\": " << top[i].pid << ",\"value\": " << top[i].value << ",\"samples\": " << top[i].samples;
+                std::cout << ",\"alive\": " << (top[i].alive ? "true" : "false") << ",\"command\": ";
+                WriteString(top[i].command.c_str());
+                std::cout << "}";
             }
+            std::cout << "]}";
         }
-        
-        std::cout << "]";
         std::cout << "}" << std::endl; // Flush with newline
+        scratch.Reset();
 
         // 4. Update Rate
         // 500ms or 1000ms is good for a desktop widget
-        std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+        next += std::chrono::milliseconds(1000);
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        if (next < now) next = now; // fell behind: resume the cadence from here rather than bursting
+        std::this_thread::sleep_until(next);
     }
 
     return 0;
@@ -1,6 +1,7 @@
 // GCC 15 COMPATIBLE - SPIDERWEB SHATTER EDITION
 #include <cstdarg> 
 #include <cstdio>
+#include <cstring>
 #include <cstdlib> 
 #include <ctime>   
 
@@ -17,9 +18,14 @@
 #include <cmath>
 #include <iomanip>
 #include <sstream>
+#include <unordered_map>
+#include <sys/stat.h>
 
 #include "System.h" 
 #include "Process.h"
+#include "Sampler.h"
+#include "Overhead.h"
+#include "Diff.h"
 
 // --- SPIDERWEB FRACTURE ENGINE ---
 // --- SPIDERWEB FRACTURE ENGINE (REALISTIC EDITION) ---
@@ -220,6 +226,51 @@ void DrawRadialProgress(const char* label, float value, float max, ImVec2 center
     draw_list->AddText(label_pos, ImColor(180, 180, 180), label);
 }
 
+// Rows = busiest IRQ sources, columns = CPUs, colour = share of the hottest cell
+void DrawIrqHeatmap(const IrqMatrix& m, size_t max_rows) {
+    size_t ncpu = m.cpus.size();
+    std::vector<std::pair<float, size_t>> order;
+    float peak = 0.0f;
+    for (size_t r = 0; r < m.names.size(); ++r) {
+        float total = 0.0f;
+        for (size_t c = 0; c < ncpu; ++c) {
+            total += m.Rate(r, c);
+            peak = std::max(peak, m.Rate(r, c));
+        }
+        if (total > 0.0f) order.push_back({total, r});
+    }
+    if (order.empty()) {
+        ImGui::TextDisabled("No interrupt activity in the last interval");
+        return;
+    }
+    std::sort(order.begin(), order.end(), [](const std::pair<float, size_t>& a, const std::pair<float, size_t>& b) { return a.first > b.first; });
+    if (order.size() > max_rows) order.resize(max_rows);
+
+    float label_w = 90.0f;
+    float cell_w = std::max(2.0f, (ImGui::GetContentRegionAvail().x - label_w) / ncpu);
+    float cell_h = 12.0f;
+    ImVec2 origin = ImGui::GetCursorScreenPos();
+    ImDrawList* draw_list = ImGui::GetWindowDrawList();
+    ImVec2 mouse = ImGui::GetMousePos();
+    bool hovered = ImGui::IsWindowHovered();
+
+    for (size_t i = 0; i < order.size(); ++i) {
+        size_t r = order[i].second;
+        float y = origin.y + i * cell_h;
+        draw_list->AddText(NULL, 11.0f, ImVec2(origin.x, y), ImColor(180, 180, 180), m.names[r].c_str());
+        for (size_t c = 0; c < ncpu; ++c) {
+            float t = sqrtf(m.Rate(r, c) / peak); // sqrt lifts the quiet cells out of the background
+            ImVec2 a = ImVec2(origin.x + label_w + c * cell_w, y);
+            ImVec2 b = ImVec2(a.x + cell_w - 1.0f, y + cell_h - 1.0f);
+            draw_list->AddRectFilled(a, b, ImColor(t, 0.2f * (1.0f - t), 1.0f - t, 0.15f + 0.85f * t));
+            if (hovered && mouse.x >= a.x && mouse.x < a.x + cell_w && mouse.y >= a.y && mouse.y < a.y + cell_h) {
+                ImGui::SetTooltip("%s  CPU%d\n%.0f /s\n%s", m.names[r].c_str(), m.cpus[c], m.Rate(r, c), m.descriptions[r].c_str());
+            }
+        }
+    }
+    ImGui::Dummy(ImVec2(label_w + cell_w * ncpu, order.size() * cell_h));
+}
+
 void SetGlassTheme() {
     ImGuiStyle& style = ImGui::GetStyle();
     style.WindowRounding = 12.0f; 
@@ -281,9 +332,70 @@ std::string FormatBytes(long bytes) {
     return ss.str();
 }
 
-int main(int, char**) {
+// $XDG_STATE_HOME/neonmonitor/history, creating the directory; empty if there is no home
+static std::string DefaultHistoryPath() {
+    std::string dir;
+    const char* state = getenv("XDG_STATE_HOME");
+    const char* home = getenv("HOME");
+    if (state && *state) dir = state;
+    else if (home && *home) {
+        dir = std::string(home) + "/.local";
+        mkdir(dir.c_str(), 0755);
+        dir += "/state";
+    } else return std::string();
+    mkdir(dir.c_str(), 0755);
+    dir += "/neonmonitor";
+    mkdir(dir.c_str(), 0755);
+    return dir + "/history";
+}
+
+int main(int argc, char** argv) {
     srand(static_cast<unsigned>(time(0)));
 
+    QuietConfig quiet;
+    std::string arg_error;
+    size_t history_budget = HistoryStore::kDefaultBudget;
+    std::string history_path;
+    bool history_path_set = false;
+    std::string record_path, replay_path;
+    size_t proc_history_budget = ProcessHistory::kDefaultBudget;
+    int64_t proc_grace_ms = ProcessHistory::kDefaultGraceMs;
+    for (int i = 1; i < argc; ++i) {
+        if (strncmp(argv[i], "--history-mb=", 13) == 0) {
+            long mb = atol(argv[i] + 13);
+            if (mb <= 0) arg_error = "--history-mb expects megabytes";
+            else history_budget = (size_t)mb << 20;
+        } else if (strncmp(argv[i], "--proc-history-mb=", 18) == 0) {
+            long mb = atol(argv[i] + 18);
+            if (mb <= 0) arg_error = "--proc-history-mb expects megabytes";
+            else proc_history_budget = (size_t)mb << 20;
+        } else if (strncmp(argv[i], "--proc-grace=", 13) == 0) {
+            long seconds = atol(argv[i] + 13);
+            if (seconds < 0 || (seconds == 0 && strcmp(argv[i] + 13, "0") != 0)) arg_error = "--proc-grace expects seconds";
+            else proc_grace_ms = seconds * 1000;
+        } else if (strncmp(argv[i], "--record=", 9) == 0) {
+            record_path = argv[i] + 9;
+        } else if (strncmp(argv[i], "--replay=", 9) == 0) {
+            replay_path = argv[i] + 9;
+        } else if (strncmp(argv[i], "--history-file=", 15) == 0) {
+            history_path = argv[i] + 15;
+            history_path_set = true;
+        }
+    }
+    if (!history_path_set) history_path = DefaultHistoryPath();
+    if (!arg_error.empty() || !Quiet::ParseArgs(argc, argv, quiet, arg_error)) {
+        std::cerr << arg_error << "\nOptions:\n"
+                  << "  --history-mb=MB    memory for metric history (default " << (HistoryStore::kDefaultBudget >> 20) << ")\n"
+                  << "  --history-file=PATH  keep history across restarts in PATH (default $XDG_STATE_HOME/neonmonitor/history;\n"
+                  << "                     empty: memory only)\n"
+                  << "  --proc-history-mb=MB  memory for per-process history (default " << (ProcessHistory::kDefaultBudget >> 20) << ")\n"
+                  << "  --proc-grace=S     keep exited processes' history S seconds (default " << ProcessHistory::kDefaultGraceMs / 1000 << ")\n"
+                  << "  --record=PATH      record the session to PATH (and PATH.idx)\n"
+                  << "  --replay=PATH      open with a recording for replay\n"
+                  << Quiet::Usage();
+        return 2;
+    }
+
     if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_TIMER) != 0) return -1;
     const char* glsl_version = "#version 130";
     
@@ -306,23 +418,72 @@ int main(int, char**) {
     ImGui_ImplSDL2_InitForOpenGL(window, gl_context);
     ImGui_ImplOpenGL3_Init(glsl_version);
 
-    System system;
-    Uint32 last_tick = SDL_GetTicks();
-    
-    float c_cpu = 0; float c_mem = 0;
-    std::pair<float,float> c_net = {0,0};
-    int c_bat = -1; bool c_online = false;
-    std::vector<Parser::DiskStats> c_disks;
-    std::vector<Process> c_procs;
+    Sampler sampler(CollectorRegistry::kDefaultTotalBudget, history_budget, history_path); // all /proc and /sys reads happen on its thread
+    if (!sampler.History().Error().empty())
+        std::cerr << "history file " << history_path << ": " << sampler.History().Error() << ", keeping history in memory\n";
+    sampler.SetQuiet(quiet);
+    sampler.SetProcessHistory(proc_history_budget, proc_grace_ms);
+    std::string record_error;
+    if (!record_path.empty() && !sampler.Record(record_path, record_error)) std::cerr << record_error << ", not recording\n";
+    sampler.Start();
+
+    int irq_view = 0; // 0: hardware, 1: softirq
+    bool sweep_bounded = true;
+    int sweep_max_pids = (int)ProcessSweep::kDefaultMaxPids;
+    int sweep_max_ms = (int)(ProcessSweep::kDefaultMaxUs / 1000);
+    bool sweep_uring = false;
+    // Process churn between snapshots, and when each pid first appeared (for the NEW marker)
+    ProcessDiffer proc_differ(0.05f);
+    uint64_t proc_version = 0;
+    size_t churn_added = 0, churn_removed = 0, churn_changed = 0;
+    std::unordered_map<int, double> proc_born;
+    // Replay and live number their process sections and string pools
+    // independently, so switching between them starts the churn over
+    auto reset_churn = [&]() {
+        proc_differ.Reset();
+        proc_version = 0;
+        churn_added = churn_removed = churn_changed = 0;
+        proc_born.clear();
+    };
+    float frame_cpu_ms = 0.0f;     // UI thread, smoothed
+    float frame_allocs = 0.0f;
+    int history_span = 0;          // index into the HISTORY window choices
+    std::vector<HistoryBucket> history_buckets;
+    std::vector<float> history_values;
+    int top_window = 1;            // index into ProcessWindows::kWindowMs
+    int top_aggregate = WINDOW_AVG_CPU;
+    std::vector<WindowRank> top_ranks;
     float max_net_kb = 10240.0f; 
+    // Replay of a recording; the sampler keeps collecting live meanwhile
+    SessionPlayer player;
+    Snapshot replay_snap;
+    bool replaying = false;
+    bool replay_paused = false;
+    int replay_speed = 0;          // index into the REPLAY speed choices
+    double replay_ms = 0.0;
+    std::string replay_error;
+    if (!replay_path.empty()) {
+        if (player.Open(replay_path, replay_error)) {
+            replaying = true;
+            reset_churn();
+            replay_ms = (double)player.StartMs();
+            player.Seek(player.StartMs(), replay_snap);
+        } else {
+            std::cerr << replay_error << "\n";
+        }
+    }
+
     int selected_pid = -1; 
+    long long selected_start = 0;  // starttime of selected_pid, so a reused pid is not mistaken for it
+    std::vector<ProcessSample> proc_samples;
     bool done = false;
 
     // UI Configuration
-    float refresh_rate = 1.0f; // Seconds
     int current_theme = 0;     // 0: Glass, 1: Cyberpunk, 2: Minimal
 
     while (!done) {
+        double frame_cpu0 = Overhead::ThreadCpuSeconds();
+        uint64_t frame_allocs0 = Overhead::ThreadAllocations();
         SDL_Event event;
         while (SDL_PollEvent(&event)) {
             ImGui_ImplSDL2_ProcessEvent(&event);
@@ -335,16 +496,30 @@ int main(int, char**) {
 
         RenderCracks(); // Draw shatter over everything
 
-        // Use configurable refresh rate
-        if (SDL_GetTicks() - last_tick > (Uint32)(refresh_rate * 1000)) {
-            c_cpu = system.GetCpuUsage();
-            c_mem = system.GetMemoryUsage();
-            c_net = system.GetNetworkStats();
-            c_online = system.IsConnected();
-            c_bat = system.GetBattery();
-            c_disks = system.GetDisks();
-            c_procs = system.GetProcesses();
-            last_tick = SDL_GetTicks();
+        // Only swaps a buffer index; the snapshot stays untouched until the next Acquire()
+        sampler.Acquire();
+        const float replay_speeds[] = { 0.25f, 1.0f, 4.0f, 16.0f, 60.0f, 600.0f, 3600.0f };
+        if (replaying && !replay_paused) {
+            replay_ms += io.DeltaTime * 1000.0 * replay_speeds[replay_speed];
+            if (!player.Advance((int64_t)replay_ms, replay_snap)) {
+                replay_ms = (double)player.EndMs();
+                replay_paused = true;
+            }
+        }
+        const Snapshot& snap = replaying ? replay_snap : sampler.Current();
+
+        // Diff only when the process section was refreshed; work scales with churn
+        if (snap.versions[SECTION_PROCESSES] != proc_version) {
+            bool first = proc_version == 0;
+            proc_version = snap.versions[SECTION_PROCESSES];
+            const ProcessDiff& diff = proc_differ.Update(snap.procs);
+            churn_added = diff.added.size();
+            churn_removed = diff.removed.size();
+            churn_changed = diff.changed.size();
+            for (int pid : diff.removed) proc_born.erase(pid);
+            if (!first) {
+                for (size_t row : diff.added) proc_born[snap.procs.pid[row]] = ImGui::GetTime();
+            }
         }
 
         ImGui::SetNextWindowPos(ImVec2(0,0));
@@ -356,8 +531,6 @@ int main(int, char**) {
         
         // --- UI CONTROLS ---
         ImGui::PushItemWidth(150);
-        ImGui::SliderFloat("Refresh (s)", &refresh_rate, 0.1f, 5.0f, "%.1f");
-        ImGui::SameLine();
         const char* themes[] = { "Glass", "Cyberpunk", "Minimal" };
         if (ImGui::Combo("Theme", &current_theme, themes, IM_ARRAYSIZE(themes))) {
             if (current_theme == 0) SetGlassTheme();
@@ -365,31 +538,82 @@ int main(int, char**) {
             else if (current_theme == 2) SetMinimalTheme();
         }
         ImGui::PopItemWidth();
+
+        // Quiet-mode badge: green when every setting took, amber when some were refused
+        const QuietStatus* quiet_status = sampler.Quiet();
+        if (quiet_status && quiet_status->enabled) {
+            ImGui::SameLine();
+            bool partial = !quiet_status->errors.empty();
+            ImGui::TextColored(partial ? ImVec4(1.0f, 0.7f, 0.2f, 1.0f) : ImVec4(0.4f, 1.0f, 0.6f, 1.0f), "[QUIET]");
+            if (ImGui::IsItemHovered()) {
+                ImGui::BeginTooltip();
+                if (quiet_status->sched_idle) ImGui::Text("Collectors: SCHED_IDLE");
+                else ImGui::Text("Collectors: nice %d", quiet_status->nice);
+                ImGui::Text("I/O priority: %s", quiet_status->io_idle ? "idle" : "unchanged");
+                ImGui::Text("CPUs: %s", quiet_status->cpus.empty() ? "unchanged" : quiet_status->cpus.c_str());
+                if (quiet_status->memory_cap_mb > 0) ImGui::Text("Memory cap: %zu MB", quiet_status->memory_cap_mb);
+                if (partial) ImGui::TextColored(ImVec4(1.0f, 0.7f, 0.2f, 1.0f), "Not applied: %s", quiet_status->errors.c_str());
+                ImGui::EndTooltip();
+            }
+        }
+        if (sampler.Recorder().IsOpen()) {
+            ImGui::SameLine();
+            ImGui::TextColored(ImVec4(1.0f, 0.3f, 0.3f, 1.0f), "[REC %.1f MB]", sampler.Recorder().BytesWritten() / 1048576.0f);
+        }
         // ------------------
 
+        // --- REPLAY ---
+        if (replaying) {
+            char when[32];
+            time_t secs = (time_t)(replay_ms / 1000.0);
+            strftime(when, sizeof(when), "%Y-%m-%d %H:%M:%S", localtime(&secs));
+            ImGui::TextColored(ImVec4(1.0f, 0.8f, 0.3f, 1.0f), "REPLAY // %s", when);
+            ImGui::SameLine();
+            if (ImGui::Button(replay_paused ? "Play" : "Pause")) replay_paused = !replay_paused;
+            ImGui::SameLine();
+            const char* speeds[] = { "0.25x", "1x", "4x", "16x", "60x", "600x", "3600x" };
+            ImGui::SetNextItemWidth(80);
+            ImGui::Combo("##speed", &replay_speed, speeds, IM_ARRAYSIZE(speeds));
+            ImGui::SameLine();
+            float offset_s = (float)((replay_ms - player.StartMs()) / 1000.0);
+            float length_s = (float)((player.EndMs() - player.StartMs()) / 1000.0);
+            ImGui::SetNextItemWidth(ImGui::GetContentRegionAvail().x - 80);
+            if (ImGui::SliderFloat("##seek", &offset_s, 0.0f, length_s, "%.0f s")) {
+                // Nearest keyframe, then the deltas after it
+                replay_ms = player.StartMs() + offset_s * 1000.0;
+                player.Seek((int64_t)replay_ms, replay_snap);
+            }
+            ImGui::SameLine();
+            if (ImGui::Button("Live")) {
+                replaying = false;
+                player.Close();
+                reset_churn();
+            }
+        }
+
         ImGui::Spacing();
 
         if (ImGui::BeginTable("GaugesTable", 4)) {
             float radius = 55.0f;
             float cell_height = radius * 2 + 50;
             ImGui::TableNextColumn();
-            DrawRadialProgress("CPU", c_cpu, 100.0f, ImVec2(ImGui::GetCursorScreenPos().x + ImGui::GetColumnWidth()/2, ImGui::GetCursorScreenPos().y + radius + 10), radius, ImVec4(0,1,1,1), "%.0f%%");
+            DrawRadialProgress("CPU", snap.cpu, 100.0f, ImVec2(ImGui::GetCursorScreenPos().x + ImGui::GetColumnWidth()/2, ImGui::GetCursorScreenPos().y + radius + 10), radius, ImVec4(0,1,1,1), "%.0f%%");
             ImGui::Dummy(ImVec2(0, cell_height));
             ImGui::TableNextColumn();
-            DrawRadialProgress("RAM", c_mem, 100.0f, ImVec2(ImGui::GetCursorScreenPos().x + ImGui::GetColumnWidth()/2, ImGui::GetCursorScreenPos().y + radius + 10), radius, ImVec4(1,0,1,1), "%.0f%%");
+            DrawRadialProgress("RAM", snap.mem, 100.0f, ImVec2(ImGui::GetCursorScreenPos().x + ImGui::GetColumnWidth()/2, ImGui::GetCursorScreenPos().y + radius + 10), radius, ImVec4(1,0,1,1), "%.0f%%");
             
-            if (c_online) {
+            if (snap.online) {
                 ImGui::TableNextColumn();
-                DrawRadialProgress("DOWN", c_net.first, max_net_kb, ImVec2(ImGui::GetCursorScreenPos().x + ImGui::GetColumnWidth()/2, ImGui::GetCursorScreenPos().y + radius + 10), radius, ImVec4(0,1,0.5,1), "%.0f KB/s");
+                DrawRadialProgress("DOWN", snap.net.first, max_net_kb, ImVec2(ImGui::GetCursorScreenPos().x + ImGui::GetColumnWidth()/2, ImGui::GetCursorScreenPos().y + radius + 10), radius, ImVec4(0,1,0.5,1), "%.0f KB/s");
                 ImGui::TableNextColumn();
-                DrawRadialProgress("UP", c_net.second, max_net_kb, ImVec2(ImGui::GetCursorScreenPos().x + ImGui::GetColumnWidth()/2, ImGui::GetCursorScreenPos().y + radius + 10), radius, ImVec4(1,0.5,0,1), "%.0f KB/s");
+                DrawRadialProgress("UP", snap.net.second, max_net_kb, ImVec2(ImGui::GetCursorScreenPos().x + ImGui::GetColumnWidth()/2, ImGui::GetCursorScreenPos().y + radius + 10), radius, ImVec4(1,0.5,0,1), "%.0f KB/s");
             }
-            if (c_bat >= 0) {
+            if (snap.battery >= 0) {
                 ImGui::TableNextColumn();
-                ImVec4 bat_col = (c_bat > 20) ? ImVec4(0,1,0,1) : ImVec4(1,0,0,1);
-                DrawRadialProgress("BATTERY", (float)c_bat, 100.0f, ImVec2(ImGui::GetCursorScreenPos().x + ImGui::GetColumnWidth()/2, ImGui::GetCursorScreenPos().y + radius + 10), radius, bat_col, "%.0f%%");
+                ImVec4 bat_col = (snap.battery > 20) ? ImVec4(0,1,0,1) : ImVec4(1,0,0,1);
+                DrawRadialProgress("BATTERY", (float)snap.battery, 100.0f, ImVec2(ImGui::GetCursorScreenPos().x + ImGui::GetColumnWidth()/2, ImGui::GetCursorScreenPos().y + radius + 10), radius, bat_col, "%.0f%%");
             }
-            for (const auto& disk : c_disks) {
+            for (const auto& disk : snap.disks) {
                 ImGui::TableNextColumn();
                 std::string used = FormatBytes(disk.used_bytes);
                 std::string total = "/ " + FormatBytes(disk.total_bytes);
@@ -400,39 +624,347 @@ int main(int, char**) {
         }
 
         ImGui::Separator();
+
+        // --- HISTORY ---
+        if (ImGui::CollapsingHeader("HISTORY")) {
+            const char* spans[] = { "30 s", "5 min", "1 h", "1 day", "7 days" };
+            const int64_t span_ms[] = { 30000, 300000, 3600000, 86400000, 604800000 };
+            ImGui::SetNextItemWidth(100);
+            ImGui::Combo("Window", &history_span, spans, IM_ARRAYSIZE(spans));
+            const HistoryStore& history = sampler.History();
+            ImGui::SameLine();
+            size_t stored = history.SamplesStored();
+            ImGui::TextDisabled("%zu series, %.1f / %.1f MB, %zu samples at %.1f B each", history.SeriesCount(), history.BytesUsed() / 1048576.0f,
+                                history.Budget() / 1048576.0f, stored, stored ? (float)history.CompressedBytes() / stored : 0.0f);
+            if (history.Rejected() > 0) {
+                ImGui::SameLine();
+                ImGui::TextColored(ImVec4(1.0f, 0.6f, 0.2f, 1.0f), "%zu series not recorded (budget full, see --history-mb, or name too long)", history.Rejected());
+            }
+            if (history.Persistent()) ImGui::TextDisabled("Kept in %s (%zu series restored)", history.Path().c_str(), history.Recovered());
+            else ImGui::TextDisabled("In memory only%s%s", history.Error().empty() ? "" : ": ", history.Error().c_str());
+
+            int64_t now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+            const char* graphs[][2] = { {"cpu", "CPU %"}, {"mem", "RAM %"}, {"net.rx_kbs", "DOWN KB/s"}, {"net.tx_kbs", "UP KB/s"} };
+            // About one point per pixel: long windows read a rollup tier, not raw samples
+            int64_t resolution_ms = span_ms[history_span] / std::max(1, (int)ImGui::GetContentRegionAvail().x - 90);
+            int64_t width_ms = 0;
+            for (const auto& graph : graphs) {
+                history.Range(history.Find(graph[0]), now_ms - span_ms[history_span], now_ms, resolution_ms, history_buckets, &width_ms);
+                history_values.clear();
+                float peak = 0.0f;
+                for (const HistoryBucket& b : history_buckets) {
+                    history_values.push_back(b.avg);
+                    peak = std::max(peak, b.max);
+                }
+                char overlay[64];
+                snprintf(overlay, sizeof(overlay), "%.1f (peak %.1f)", history_values.empty() ? 0.0f : history_values.back(), peak);
+                ImGui::PlotLines(graph[1], history_values.data(), (int)history_values.size(), 0, overlay, 0.0f, FLT_MAX, ImVec2(-90, 50));
+            }
+            if (width_ms > 0) ImGui::TextDisabled("%zu points, %lld s buckets (avg, peak of max)", history_values.size(), (long long)(width_ms / 1000));
+            else ImGui::TextDisabled("%zu points, raw samples", history_values.size());
+        }
+
+        // --- COLLECTOR CADENCE ---
+        if (ImGui::CollapsingHeader("CADENCE")) {
+            if (ImGui::BeginTable("cadence_table", 6, ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerH)) {
+                ImGui::TableSetupColumn("COLLECTOR", ImGuiTableColumnFlags_WidthFixed, 110.0f);
+                ImGui::TableSetupColumn("PERIOD");
+                ImGui::TableSetupColumn("APPLIED", ImGuiTableColumnFlags_WidthFixed, 70.0f);
+                ImGui::TableSetupColumn("EFFECTIVE", ImGuiTableColumnFlags_WidthFixed, 80.0f);
+                ImGui::TableSetupColumn("CPU/RUN", ImGuiTableColumnFlags_WidthFixed, 80.0f);
+                ImGui::TableSetupColumn("BUDGET", ImGuiTableColumnFlags_WidthFixed, 110.0f);
+                ImGui::TableHeadersRow();
+                for (size_t i = 0; i < snap.cadence.size(); i++) {
+                    const CadenceInfo& c = snap.cadence[i];
+                    ImVec4 warn = ImVec4(1.0f, 0.3f, 0.3f, 1.0f);
+                    ImGui::PushID((int)i);
+                    ImGui::TableNextRow();
+                    ImGui::TableSetColumnIndex(0);
+                    ImGui::Text("%s", c.name.c_str());
+                    ImGui::TableSetColumnIndex(1);
+                    float period = c.period;
+                    ImGui::SetNextItemWidth(-1);
+                    if (ImGui::SliderFloat("##period", &period, 0.1f, 60.0f, "%.1f s", ImGuiSliderFlags_Logarithmic)) {
+                        sampler.SetPeriod((int)i, period);
+                    }
+                    ImGui::TableSetColumnIndex(2);
+                    // Stretched by the budget governor
+                    bool throttled = c.applied_period > c.period * 1.05f;
+                    if (throttled) ImGui::TextColored(warn, "%.1f s", c.applied_period);
+                    else ImGui::Text("%.1f s", c.applied_period);
+                    ImGui::TableSetColumnIndex(3);
+                    // Falling short of 1/period means the collector thread cannot keep up
+                    bool lagging = c.effective_hz > 0.0f && c.effective_hz < 0.8f / c.applied_period;
+                    if (lagging) ImGui::TextColored(warn, "%.2f Hz", c.effective_hz);
+                    else ImGui::Text("%.2f Hz", c.effective_hz);
+                    ImGui::TableSetColumnIndex(4);
+                    ImGui::Text("%.2f ms", c.cpu_ms);
+                    ImGui::TableSetColumnIndex(5);
+                    ImGui::Text("%.2f / %.2f%%", c.used_percent, c.budget_percent);
+                    ImGui::PopID();
+                }
+                ImGui::EndTable();
+            }
+        }
+
+        // --- SELF OVERHEAD ---
+        if (ImGui::CollapsingHeader("SELF OVERHEAD")) {
+            const SelfUsage& self = snap.self;
+            ImGui::Text("Process: %.2f%% CPU, %.1f MB RSS", self.cpu_percent, self.rss_kb / 1024.0f);
+            ImGui::Text("Heap: %.0f allocs/s (%.1f KB/s)", self.allocs_per_sec, self.alloc_kb_per_sec);
+            ImGui::Text("Reads: %.0f syscalls/s (%.1f KB/s)", self.read_syscalls_per_sec, self.read_kb_per_sec);
+            ImGui::Text("UI frame: %.2f ms CPU, %.0f allocs", frame_cpu_ms, frame_allocs);
+            if (ImGui::BeginTable("self_table", 5, ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerH)) {
+                ImGui::TableSetupColumn("COLLECTOR", ImGuiTableColumnFlags_WidthFixed, 110.0f);
+                ImGui::TableSetupColumn("CPU/RUN");
+                ImGui::TableSetupColumn("SYSCALLS/RUN");
+                ImGui::TableSetupColumn("READ/RUN");
+                ImGui::TableSetupColumn("ALLOCS/RUN");
+                ImGui::TableHeadersRow();
+                for (const CadenceInfo& c : snap.cadence) {
+                    ImGui::TableNextRow();
+                    ImGui::TableSetColumnIndex(0);
+                    ImGui::Text("%s", c.name.c_str());
+                    ImGui::TableSetColumnIndex(1);
+                    ImGui::Text("%.2f ms", c.cpu_ms);
+                    ImGui::TableSetColumnIndex(2);
+                    ImGui::Text("%.0f", c.read_syscalls);
+                    ImGui::TableSetColumnIndex(3);
+                    ImGui::Text("%.1f KB", c.read_kb);
+                    ImGui::TableSetColumnIndex(4);
+                    ImGui::Text("%.0f", c.allocs);
+                }
+                ImGui::EndTable();
+            }
+        }
+
+        // --- KERNEL ACTIVITY ---
+        if (ImGui::CollapsingHeader("KERNEL ACTIVITY")) {
+            if (ImGui::BeginTable("kernel_table", 4, ImGuiTableFlags_BordersInnerV)) {
+                // alarm: any non-zero value deserves attention (swapping, OOM kills)
+                struct Row { const char* label; float value; const char* unit; bool alarm; };
+                Row rows[] = {
+                    {"Page faults", snap.kernel.pgfault, "/s", false},        {"Major faults", snap.kernel.pgmajfault, "/s", false},
+                    {"Swap in", snap.kernel.pswpin, "pg/s", true},            {"Swap out", snap.kernel.pswpout, "pg/s", true},
+                    {"Reclaim scan", snap.kernel.pgscan, "pg/s", false},      {"Reclaim steal", snap.kernel.pgsteal, "pg/s", false},
+                    {"OOM kills", snap.kernel.oom_kill, "/s", true},          {"Forks", snap.kernel.forks, "/s", false},
+                    {"Ctx switches", snap.kernel.ctxt, "/s", false},          {"Interrupts", snap.kernel.intr, "/s", false},
+                    {"Running", (float)snap.kernel.procs_running, "", false}, {"Blocked (D)", (float)snap.kernel.procs_blocked, "", false},
+                };
+                for (const Row& row : rows) {
+                    ImGui::TableNextColumn();
+                    ImGui::TextDisabled("%s", row.label);
+                    ImGui::TableNextColumn();
+                    if (row.alarm && row.value > 0.0f) ImGui::TextColored(ImVec4(1.0f, 0.3f, 0.3f, 1.0f), "%.0f %s", row.value, row.unit);
+                    else ImGui::Text("%.0f %s", row.value, row.unit);
+                }
+                ImGui::EndTable();
+            }
+        }
+
+        // --- INTERRUPT HEATMAP ---
+        if (ImGui::CollapsingHeader("INTERRUPTS")) {
+            ImGui::RadioButton("Hardware", &irq_view, 0);
+            ImGui::SameLine();
+            ImGui::RadioButton("Softirq", &irq_view, 1);
+            DrawIrqHeatmap(irq_view == 0 ? snap.irq : snap.softirq, 24);
+        }
+
+        // --- NUMA ---
+        if (ImGui::CollapsingHeader("NUMA")) {
+            if (ImGui::BeginTable("numa_table", 7, ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerH)) {
+                ImGui::TableSetupColumn("NODE", ImGuiTableColumnFlags_WidthFixed, 50.0f);
+                ImGui::TableSetupColumn("MEMORY");
+                ImGui::TableSetupColumn("LOCAL", ImGuiTableColumnFlags_WidthFixed, 60.0f);
+                ImGui::TableSetupColumn("HIT/s", ImGuiTableColumnFlags_WidthFixed, 80.0f);
+                ImGui::TableSetupColumn("MISS/s", ImGuiTableColumnFlags_WidthFixed, 80.0f);
+                ImGui::TableSetupColumn("FOREIGN/s", ImGuiTableColumnFlags_WidthFixed, 80.0f);
+                ImGui::TableSetupColumn("REMOTE/s", ImGuiTableColumnFlags_WidthFixed, 80.0f);
+                ImGui::TableHeadersRow();
+                for (const auto& node : snap.numa) {
+                    ImGui::TableNextRow();
+                    ImGui::TableSetColumnIndex(0);
+                    ImGui::Text("%d", node.id);
+                    ImGui::TableSetColumnIndex(1);
+                    char overlay[48];
+                    snprintf(overlay, sizeof(overlay), "%s / %s", FormatBytes((node.total_kb - node.free_kb) * 1024).c_str(), FormatBytes(node.total_kb * 1024).c_str());
+                    ImGui::ProgressBar(node.percent_used / 100.0f, ImVec2(-1, 0), overlay);
+                    ImGui::TableSetColumnIndex(2);
+                    ImGui::Text("%.0f%%", node.local_percent);
+                    ImGui::TableSetColumnIndex(3);
+                    ImGui::Text("%.0f", node.hit);
+                    ImGui::TableSetColumnIndex(4);
+                    ImGui::Text("%.0f", node.miss);
+                    ImGui::TableSetColumnIndex(5);
+                    ImGui::Text("%.0f", node.foreign);
+                    ImGui::TableSetColumnIndex(6);
+                    ImGui::Text("%.0f", node.other);
+                }
+                ImGui::EndTable();
+            }
+
+            if (snap.numa_proc.pid >= 0 && snap.numa_proc.total_kb > 0) {
+                ImGui::Text("PID %d // home node %d // %.0f%% local", snap.numa_proc.pid, snap.numa_proc.home_node, snap.numa_proc.local_percent);
+                for (size_t i = 0; i < snap.numa_proc.node_ids.size(); ++i) {
+                    char overlay[48];
+                    snprintf(overlay, sizeof(overlay), "N%d  %.1f MB", snap.numa_proc.node_ids[i], snap.numa_proc.node_kb[i] / 1024.0f);
+                    bool local = snap.numa_proc.node_ids[i] == snap.numa_proc.home_node;
+                    ImGui::PushStyleColor(ImGuiCol_PlotHistogram, local ? ImVec4(0, 1, 0.5f, 1) : ImVec4(1, 0.5f, 0, 1));
+                    ImGui::ProgressBar((float)snap.numa_proc.node_kb[i] / snap.numa_proc.total_kb, ImVec2(-1, 0), overlay);
+                    ImGui::PopStyleColor();
+                }
+            } else if (selected_pid >= 0) {
+                ImGui::TextDisabled("No NUMA placement readable for PID %d", selected_pid);
+            } else {
+                ImGui::TextDisabled("Select a process to see its per-node placement");
+            }
+        }
+
+        // --- FILE DESCRIPTOR WATCH ---
+        if (ImGui::CollapsingHeader("FILE DESCRIPTORS")) {
+            if (ImGui::BeginTable("fd_table", 5, ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerH)) {
+                ImGui::TableSetupColumn("PID", ImGuiTableColumnFlags_WidthFixed, 60.0f);
+                ImGui::TableSetupColumn("FDS", ImGuiTableColumnFlags_WidthFixed, 80.0f);
+                ImGui::TableSetupColumn("LIMIT", ImGuiTableColumnFlags_WidthFixed, 120.0f);
+                ImGui::TableSetupColumn("GROWTH", ImGuiTableColumnFlags_WidthFixed, 80.0f);
+                ImGui::TableSetupColumn("COMMAND");
+                ImGui::TableHeadersRow();
+
+                for (size_t i = 0; i < snap.fds.size() && i < 10; i++) {
+                    const FdUsage& fd = snap.fds[i];
+                    long row = snap.procs.Find(fd.pid);
+                    ImVec4 col = fd.near_limit ? ImVec4(1.0f, 0.3f, 0.3f, 1.0f) : ImGui::GetStyle().Colors[ImGuiCol_Text];
+
+                    ImGui::TableNextRow();
+                    ImGui::TableSetColumnIndex(0);
+                    ImGui::TextColored(col, "%d", fd.pid);
+                    ImGui::TableSetColumnIndex(1);
+                    ImGui::TextColored(col, fd.counting ? ">=%ld" : "%ld", fd.fd_count);
+                    ImGui::TableSetColumnIndex(2);
+                    if (fd.soft_limit > 0) ImGui::TextColored(col, "%ld (%.0f%%)", fd.soft_limit, fd.limit_percent);
+                    else ImGui::TextColored(col, "unlimited");
+                    ImGui::TableSetColumnIndex(3);
+                    ImGui::TextColored(col, "%+.1f/s", fd.growth_per_sec);
+                    ImGui::TableSetColumnIndex(4);
+                    ImGui::TextColored(col, "%s", row >= 0 ? snap.procs.Command(row) : "");
+                }
+                ImGui::EndTable();
+            }
+        }
+
+        // --- TOP OVER A WINDOW ---
+        // Ranked from sliding-window aggregates kept by the sampler, not by rereading history
+        if (ImGui::CollapsingHeader("TOP OVER TIME")) {
+            const char* windows[] = { "1 min", "5 min", "1 h" };
+            static_assert(IM_ARRAYSIZE(windows) == ProcessWindows::kWindows, "one label per window");
+            const char* aggregates[] = { "avg CPU", "max CPU", "avg RSS", "max RSS" };
+            static_assert(IM_ARRAYSIZE(aggregates) == WINDOW_AGGREGATE_COUNT, "one label per aggregate");
+            ImGui::SetNextItemWidth(100);
+            ImGui::Combo("##top_window", &top_window, windows, IM_ARRAYSIZE(windows));
+            ImGui::SameLine();
+            ImGui::SetNextItemWidth(100);
+            ImGui::Combo("##top_aggregate", &top_aggregate, aggregates, IM_ARRAYSIZE(aggregates));
+            ImGui::SameLine();
+            const ProcessWindows& windowed = sampler.Windows();
+            ImGui::TextDisabled("%zu processes in the last %s", windowed.SeriesCount(), windows[top_window]);
+            windowed.Top(top_window, (WindowAggregate)top_aggregate, 10, top_ranks);
+            bool rss = top_aggregate == WINDOW_AVG_RSS || top_aggregate == WINDOW_MAX_RSS;
+            if (ImGui::BeginTable("top_table", 4, ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerH)) {
+                ImGui::TableSetupColumn("PID", ImGuiTableColumnFlags_WidthFixed, 60.0f);
+                ImGui::TableSetupColumn(aggregates[top_aggregate], ImGuiTableColumnFlags_WidthFixed, 90.0f);
+                ImGui::TableSetupColumn("SAMPLES", ImGuiTableColumnFlags_WidthFixed, 70.0f);
+                ImGui::TableSetupColumn("COMMAND");
+                ImGui::TableHeadersRow();
+                for (const WindowRank& r : top_ranks) {
+                    ImGui::TableNextRow();
+                    ImGui::TableSetColumnIndex(0);
+                    char label[32];
+                    snprintf(label, sizeof(label), "%d##top", r.pid);
+                    if (ImGui::Selectable(label, selected_pid == r.pid && selected_start == r.starttime, ImGuiSelectableFlags_SpanAllColumns)) {
+                        selected_pid = r.pid;
+                        selected_start = r.starttime;
+                        sampler.SetSelectedPid(selected_pid);
+                    }
+                    ImGui::TableSetColumnIndex(1);
+                    if (rss) ImGui::Text("%.1f MB", r.value);
+                    else ImGui::Text("%.1f %%", r.value);
+                    ImGui::TableSetColumnIndex(2);
+                    ImGui::Text("%u", r.samples);
+                    ImGui::TableSetColumnIndex(3);
+                    if (r.alive) ImGui::Text("%s", r.command.c_str());
+                    else ImGui::TextDisabled("%s (exited)", r.command.c_str());
+                }
+                ImGui::EndTable();
+            }
+        }
+
         ImGui::Text("ACTIVE PROCESSES");
-        
-        if (ImGui::BeginTable("proc_table", 3, ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerH | ImGuiTableFlags_ScrollY)) {
+        ImGui::SameLine();
+        ImGui::TextDisabled("%zu/%zu refreshed (%zu hot, %zu idle backed off) in %.1f ms%s, oldest %.1f s",
+                            snap.sweep.sampled, snap.sweep.known, snap.sweep.hot, snap.sweep.backed_off,
+                            snap.sweep.tick_ms, snap.sweep.uring ? " via io_uring" : "", snap.sweep.oldest_age_s);
+
+        ImGui::SameLine();
+        ImGui::TextDisabled("| +%zu -%zu ~%zu", churn_added, churn_removed, churn_changed);
+
+        // --- BOUNDED SWEEP ---
+        // Caps the work per process-collector run so latency stays flat on hosts with huge pid counts
+        bool sweep_changed = ImGui::Checkbox("Bounded sweep", &sweep_bounded);
+        if (sweep_bounded) {
+            ImGui::SameLine();
+            ImGui::SetNextItemWidth(140.0f);
+            sweep_changed |= ImGui::SliderInt("##sweep_pids", &sweep_max_pids, 64, 65536, "%d pids", ImGuiSliderFlags_Logarithmic);
+            ImGui::SameLine();
+            ImGui::SetNextItemWidth(140.0f);
+            sweep_changed |= ImGui::SliderInt("##sweep_ms", &sweep_max_ms, 1, 500, "%d ms", ImGuiSliderFlags_Logarithmic);
+        }
+        ImGui::SameLine();
+        if (ImGui::Checkbox("io_uring", &sweep_uring)) sampler.SetSweepUring(sweep_uring);
+        if (sweep_changed) {
+            if (sweep_bounded) sampler.SetSweepBudget((size_t)sweep_max_pids, sweep_max_ms * 1000L);
+            else sampler.SetSweepBudget(0, 0);
+        }
+
+        // Leave room for the connection table below when a process is selected
+        ImVec2 proc_table_size = ImVec2(0, selected_pid >= 0 ? ImGui::GetContentRegionAvail().y * 0.55f : 0.0f);
+        if (ImGui::BeginTable("proc_table", 5, ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerH | ImGuiTableFlags_ScrollY, proc_table_size)) {
             ImGui::TableSetupColumn("PID", ImGuiTableColumnFlags_WidthFixed, 60.0f);
             ImGui::TableSetupColumn("CPU", ImGuiTableColumnFlags_WidthFixed, 60.0f);
+            ImGui::TableSetupColumn("CONN", ImGuiTableColumnFlags_WidthFixed, 50.0f);
+            ImGui::TableSetupColumn("AGE", ImGuiTableColumnFlags_WidthFixed, 50.0f);
             ImGui::TableSetupColumn("COMMAND");
             ImGui::TableHeadersRow();
+            std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
 
-            std::sort(c_procs.begin(), c_procs.end(), [](const Process& a, const Process& b) { return a.cpuUsage > b.cpuUsage; });
-
-            for (size_t i = 0; i < c_procs.size() && i < 30; i++) {
-                ImGui::PushID(c_procs[i].pid); 
+            for (size_t i = 0; i < snap.procs.order.size() && i < 30; i++) {
+                size_t row = snap.procs.order[i];
+                int pid = snap.procs.pid[row];
+                ImGui::PushID(pid);
                 ImGui::TableNextRow();
                 ImGui::TableSetColumnIndex(0);
 
                 char label[32];
-                sprintf(label, "%d", c_procs[i].pid);
-                bool is_selected = (selected_pid == c_procs[i].pid);
-                if (ImGui::Selectable(label, is_selected, ImGuiSelectableFlags_SpanAllColumns)) selected_pid = c_procs[i].pid;
+                sprintf(label, "%d", pid);
+                bool is_selected = (selected_pid == pid);
+                if (ImGui::Selectable(label, is_selected, ImGuiSelectableFlags_SpanAllColumns)) {
+                    selected_pid = pid;
+                    selected_start = snap.procs.starttime[row];
+                    sampler.SetSelectedPid(selected_pid);
+                }
 
                 if (ImGui::BeginPopupContextItem("context_menu")) {
-                    ImGui::Text("System Actions: %d", c_procs[i].pid);
+                    ImGui::Text("System Actions: %d", pid);
                     ImGui::Separator();
                     
                     if (ImGui::MenuItem("Terminate")) {
-                        system.TerminateProcess(c_procs[i].pid);
+                        System::TerminateProcess(pid);
                         ImVec2 m = ImGui::GetMousePos();
                         AddShatterEffect(m.x, m.y);
                     }
                     
                     ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(1.0f, 0.3f, 0.3f, 1.0f));
                     if (ImGui::MenuItem("SHATTER (KILL)")) {
-                        system.KillProcess(c_procs[i].pid);
+                        System::KillProcess(pid);
                         ImVec2 m = ImGui::GetMousePos();
                         AddShatterEffect(m.x, m.y); // Creates the spiderweb!
                     }
@@ -441,14 +973,95 @@ int main(int, char**) {
                 }
 
                 ImGui::TableSetColumnIndex(1);
-                ImGui::Text("%.1f %%", c_procs[i].cpuUsage);
+                ImGui::Text("%.1f %%", snap.procs.cpu[row]);
                 ImGui::TableSetColumnIndex(2);
-                ImGui::Text("%s", c_procs[i].command.c_str());
+                auto conn = snap.conn_count.find(pid);
+                ImGui::Text("%d", conn != snap.conn_count.end() ? conn->second : 0);
+                ImGui::TableSetColumnIndex(3);
+                // Rows the bounded sweep has not reached lately show their data age
+                float age = std::chrono::duration<float>(now - snap.procs.sampled_at[row]).count();
+                if (age < 2.0f) ImGui::TextDisabled("%.1fs", age);
+                else ImGui::TextColored(ImVec4(1.0f, 0.8f, 0.3f, 1.0f), "%.0fs", age);
+                ImGui::TableSetColumnIndex(4);
+                // Processes that appeared in the last 5 seconds
+                auto born = proc_born.find(pid);
+                if (born != proc_born.end() && ImGui::GetTime() - born->second < 5.0) {
+                    ImGui::TextColored(ImVec4(0.4f, 1.0f, 0.6f, 1.0f), "NEW");
+                    ImGui::SameLine();
+                }
+                ImGui::Text("%s", snap.procs.Command(row));
                 ImGui::PopID(); 
             }
             ImGui::EndTable();
         }
 
+        // --- CONNECTIONS OF THE SELECTED PROCESS ---
+        if (selected_pid >= 0) {
+            // --- HISTORY OF THE SELECTED PROCESS ---
+            ImGui::Separator();
+            ProcessHistory& proc_history = sampler.ProcHistory();
+            int64_t now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+            if (proc_history.Range(selected_pid, selected_start, now_ms - 600000, now_ms, proc_samples) && !proc_samples.empty()) {
+                history_values.clear();
+                float peak = 0.0f;
+                for (const ProcessSample& p : proc_samples) {
+                    history_values.push_back(p.cpu);
+                    peak = std::max(peak, p.cpu);
+                }
+                char overlay[64];
+                snprintf(overlay, sizeof(overlay), "%.1f%% (peak %.1f)", history_values.back(), peak);
+                ImGui::PlotLines("CPU %", history_values.data(), (int)history_values.size(), 0, overlay, 0.0f, FLT_MAX, ImVec2(-90, 40));
+                history_values.clear();
+                peak = 0.0f;
+                for (const ProcessSample& p : proc_samples) {
+                    history_values.push_back(p.rss_mb);
+                    peak = std::max(peak, p.rss_mb);
+                }
+                snprintf(overlay, sizeof(overlay), "%.1f MB (peak %.1f)", history_values.back(), peak);
+                ImGui::PlotLines("RSS MB", history_values.data(), (int)history_values.size(), 0, overlay, 0.0f, FLT_MAX, ImVec2(-90, 40));
+            } else {
+                ImGui::TextDisabled("No history kept for PID %d", selected_pid);
+            }
+            ImGui::TextDisabled("%zu processes tracked (%zu exited, kept %llds), %zu / %zu chunks, %zu evicted", proc_history.SeriesCount(),
+                                proc_history.DeadCount(), (long long)(proc_history.GraceMs() / 1000), proc_history.ChunksUsed(),
+                                proc_history.ChunkCount(), proc_history.Evictions());
+
+            ImGui::Separator();
+            ImGui::Text("CONNECTIONS // PID %d", selected_pid);
+            if (ImGui::BeginTable("conn_table", 7, ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerH | ImGuiTableFlags_ScrollY)) {
+                ImGui::TableSetupColumn("LOCAL");
+                ImGui::TableSetupColumn("REMOTE");
+                ImGui::TableSetupColumn("STATE", ImGuiTableColumnFlags_WidthFixed, 90.0f);
+                ImGui::TableSetupColumn("RTT", ImGuiTableColumnFlags_WidthFixed, 70.0f);
+                ImGui::TableSetupColumn("RETRANS", ImGuiTableColumnFlags_WidthFixed, 60.0f);
+                ImGui::TableSetupColumn("ACKED", ImGuiTableColumnFlags_WidthFixed, 80.0f);
+                ImGui::TableSetupColumn("RCVD", ImGuiTableColumnFlags_WidthFixed, 80.0f);
+                ImGui::TableHeadersRow();
+
+                int shown = 0;
+                for (const auto& sock : snap.sockets) {
+                    if (sock.pid != selected_pid) continue;
+                    if (++shown > 200) break; // a busy server can hold thousands; the count column has the total
+                    ImGui::TableNextRow();
+                    ImGui::TableSetColumnIndex(0);
+                    ImGui::Text("%s", SocketCollector::FormatEndpoint(sock.family, sock.local_addr, sock.local_port).c_str());
+                    ImGui::TableSetColumnIndex(1);
+                    ImGui::Text("%s", SocketCollector::FormatEndpoint(sock.family, sock.remote_addr, sock.remote_port).c_str());
+                    ImGui::TableSetColumnIndex(2);
+                    ImGui::Text("%s", SocketCollector::StateName(sock.state));
+                    ImGui::TableSetColumnIndex(3);
+                    ImGui::Text("%.1f ms", sock.rtt_us / 1000.0f);
+                    ImGui::TableSetColumnIndex(4);
+                    ImGui::Text("%u", sock.retransmits);
+                    ImGui::TableSetColumnIndex(5);
+                    ImGui::Text("%llu", (unsigned long long)sock.bytes_acked);
+                    ImGui::TableSetColumnIndex(6);
+                    ImGui::Text("%llu", (unsigned long long)sock.bytes_received);
+                }
+                ImGui::EndTable();
+            }
+        }
+
         ImGui::End();
         ImGui::Render();
         glViewport(0, 0, (int)io.DisplaySize.x, (int)io.DisplaySize.y);
@@ -456,8 +1069,13 @@ int main(int, char**) {
         glClear(GL_COLOR_BUFFER_BIT);
         ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
         SDL_GL_SwapWindow(window);
+
+        // Thread CPU time only: blocking on vsync does not count
+        frame_cpu_ms = frame_cpu_ms * 0.9f + (float)((Overhead::ThreadCpuSeconds() - frame_cpu0) * 1000.0) * 0.1f;
+        frame_allocs = frame_allocs * 0.9f + (float)(Overhead::ThreadAllocations() - frame_allocs0) * 0.1f;
     }
 
+    sampler.Stop();
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplSDL2_Shutdown();
     ImGui::DestroyContext();
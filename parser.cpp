@@ -10,53 +10,111 @@
 #include <iostream>
 #include <sys/statvfs.h> 
 #include <cstring>
+#include <cstdio>
+#include <fcntl.h>
 
-float Parser::CpuUsage() {
-    std::ifstream file("/proc/stat");
-    std::string line, cpu;
-    long user, nice, system, idle, iowait, irq, softirq;
-    std::getline(file, line);
-    std::istringstream ss(line);
-    ss >> cpu >> user >> nice >> system >> idle >> iowait >> irq >> softirq;
-    long total = user + nice + system + idle + iowait + irq + softirq;
-    return 100.0 * (total - idle) / total;
+size_t Parser::ReadWhole(int fd, std::vector<char>& buf) {
+    if (fd < 0) return 0;
+    if (buf.empty()) buf.resize(4096);
+    size_t len = 0;
+    while (true) {
+        if (len == buf.size()) buf.resize(buf.size() * 2);
+        ssize_t n = pread(fd, buf.data() + len, buf.size() - len, len);
+        if (n < 0) return 0;
+        if (n == 0) return len;
+        len += n;
+    }
 }
 
-float Parser::MemoryUsage() {
-    std::ifstream file("/proc/meminfo");
-    std::string key, unit;
-    float value, total = 0, available = 0;
-    while (file >> key >> value >> unit) {
-        if (key == "MemTotal:") total = value;
-        else if (key == "MemAvailable:") {
-            available = value;
-            break;
-        }
+size_t Parser::ReadFile(const char* path, char* buf, size_t size) {
+    buf[0] = '\0';
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return 0;
+    ssize_t n = read(fd, buf, size - 1);
+    close(fd);
+    if (n <= 0) return 0;
+    buf[n] = '\0';
+    return (size_t)n;
+}
+
+// "/proc/<pid>/<file>" without going through std::string
+static void ProcPath(char* out, size_t size, int pid, const char* file) {
+    snprintf(out, size, "/proc/%d/%s", pid, file);
+}
+
+Parser::CpuTimes Parser::GetCpuTimes() {
+    // The aggregate line comes first: "cpu  user nice system idle iowait irq softirq steal ..."
+    char buf[512];
+    CpuTimes t = {0, 0};
+    if (Parser::ReadFile("/proc/stat", buf, sizeof(buf)) < 4 || strncmp(buf, "cpu ", 4) != 0) return t;
+    long long v[8] = {0};
+    char* p = buf + 4;
+    for (int i = 0; i < 8; ++i) v[i] = strtoll(p, &p, 10);
+    long long idle = v[3], iowait = v[4];
+    t.total = v[0] + v[1] + v[2] + idle + iowait + v[5] + v[6] + v[7];
+    t.busy = t.total - idle - iowait;
+    return t;
+}
+
+// Value of "Key:   123 kB" in a /proc/meminfo-style buffer, -1 if missing
+static long long KeyValue(const char* text, const char* key) {
+    size_t key_len = strlen(key);
+    for (const char* line = text; *line;) {
+        if (strncmp(line, key, key_len) == 0) return strtoll(line + key_len, nullptr, 10);
+        const char* nl = strchr(line, '\n');
+        if (!nl) break;
+        line = nl + 1;
     }
-    if (total == 0) return 0;
+    return -1;
+}
+
+float Parser::MemoryUsage() {
+    // MemTotal, MemFree and MemAvailable are the first three lines
+    char buf[1024];
+    if (Parser::ReadFile("/proc/meminfo", buf, sizeof(buf)) == 0) return 0;
+    long long total = KeyValue(buf, "MemTotal:");
+    long long available = KeyValue(buf, "MemAvailable:");
+    if (total <= 0 || available < 0) return 0;
     return 100.0 * (total - available) / total;
 }
 
-Parser::NetStats Parser::GetNetworkTraffic() {
-    std::ifstream file("/proc/net/dev");
-    std::string line;
-    long total_rx = 0;
-    long total_tx = 0;
-    std::getline(file, line); 
-    std::getline(file, line); 
-    while (std::getline(file, line)) {
-        std::istringstream ss(line);
-        std::string iface;
-        long rx, tx, junk;
-        ss >> iface; 
-        if (line.find("lo:") != std::string::npos) continue;
-        ss >> rx;
-        for (int i = 0; i < 7; ++i) ss >> junk;
-        ss >> tx;
-        total_rx += rx;
-        total_tx += tx;
+Parser::NetStats Parser::GetNetworkTraffic(std::pmr::memory_resource* scratch) {
+    // One line per interface, so the file is read whole into scratch
+    NetStats stats = {0, 0};
+    int fd = open("/proc/net/dev", O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return stats;
+    std::pmr::vector<char> buf(4096, scratch);
+    size_t len = 0;
+    while (true) {
+        if (len == buf.size()) buf.resize(buf.size() * 2);
+        ssize_t n = read(fd, buf.data() + len, buf.size() - len);
+        if (n <= 0) break;
+        len += n;
     }
-    return {total_rx, total_tx};
+    close(fd);
+
+    // Two header lines, then "  iface: rx_bytes packets errs drop fifo frame compressed multicast tx_bytes ..."
+    const char* p = buf.data();
+    const char* end = p + len;
+    int line = 0;
+    while (p < end) {
+        const char* nl = (const char*)memchr(p, '\n', end - p);
+        if (!nl) nl = end;
+        const char* colon = (const char*)memchr(p, ':', nl - p);
+        if (line++ >= 2 && colon) {
+            const char* name = p;
+            while (name < colon && *name == ' ') ++name;
+            if (!(colon - name == 2 && name[0] == 'l' && name[1] == 'o')) {
+                char* q = (char*)colon + 1;
+                long v[9];
+                for (int i = 0; i < 9; ++i) v[i] = strtol(q, &q, 10);
+                stats.rx_bytes += v[0];
+                stats.tx_bytes += v[8];
+            }
+        }
+        p = nl + 1;
+    }
+    return stats;
 }
 
 // --- CONNECTIVITY CHECK ---
@@ -142,60 +200,153 @@ std::vector<Parser::DiskStats> Parser::GetDiskUsage() {
     return disks;
 }
 
-std::vector<int> Parser::Pids() {
-    std::vector<int> pids;
+// Numeric entries of /proc; d_name is parsed in place
+template <typename Out>
+static void ListPids(Out& pids) {
     DIR* dir = opendir("/proc");
+    if (!dir) return;
     struct dirent* entry;
     while ((entry = readdir(dir)) != nullptr) {
-        if (entry->d_type == DT_DIR) {
-            std::string name(entry->d_name);
-            if (std::all_of(name.begin(), name.end(), ::isdigit)) {
-                pids.push_back(std::stoi(name));
-            }
-        }
+        if (entry->d_type != DT_DIR) continue;
+        const char* name = entry->d_name;
+        int pid = 0;
+        for (; *name >= '0' && *name <= '9'; ++name) pid = pid * 10 + (*name - '0');
+        if (*name == '\0' && name != entry->d_name) pids.push_back(pid);
     }
     closedir(dir);
+}
+
+std::vector<int> Parser::Pids() {
+    std::vector<int> pids;
+    ListPids(pids);
     return pids;
 }
 
+std::pmr::vector<int> Parser::Pids(std::pmr::memory_resource* scratch) {
+    std::pmr::vector<int> pids(scratch);
+    pids.reserve(1024);
+    ListPids(pids);
+    return pids;
+}
+
+bool Parser::ProcessStat(int pid, ProcStat& out) {
+    char path[64], buf[1024];
+    ProcPath(path, sizeof(path), pid, "stat");
+    size_t len = Parser::ReadFile(path, buf, sizeof(buf));
+    if (len == 0) return false;
+    return ParseProcessStat(buf, len, out);
+}
+
+bool Parser::ParseProcessStat(const char* text, size_t len, ProcStat& out) {
+    // comm may contain spaces and parens: fields are counted from the last ')'
+    const char* end = text + len;
+    const char* open = (const char*)memchr(text, '(', len);
+    const char* close = end;
+    while (close > text && close[-1] != ')') --close;
+    if (!open || close == text || open >= close) return false;
+    out.comm.assign(open + 1, close - 1);
+
+    // Field 3 (state) onwards; only the numeric ones we keep are converted
+    long long values[37];
+    int count = 0;
+    const char* p = close;
+    while (p < end && *p == ' ') ++p;
+    out.state = p < end ? *p : '?';
+    while (count < 37) {
+        while (p < end && *p == ' ') ++p;
+        if (p >= end || *p == '\n') break;
+        bool negative = *p == '-';
+        if (negative) ++p;
+        long long v = 0;
+        while (p < end && *p >= '0' && *p <= '9') v = v * 10 + (*p++ - '0');
+        while (p < end && *p != ' ' && *p != '\n') ++p; // the state letter
+        values[count++] = negative ? -v : v;
+    }
+    // values[0] is field 3 (state)
+    if (count < 20) return false;
+    out.ppid = (int)values[1];
+    out.utime = (long)values[11];
+    out.stime = (long)values[12];
+    out.cutime = (long)values[13];
+    out.cstime = (long)values[14];
+    out.starttime = values[19];
+    out.processor = count > 36 ? (int)values[36] : -1;
+    return true;
+}
+
 float Parser::ProcessCpuUsage(int pid) {
-    std::ifstream file("/proc/" + std::to_string(pid) + "/stat");
-    std::string value;
-    std::vector<std::string> values;
-    while (file >> value) values.push_back(value);
-    if (values.size() < 22) return 0.0;
-    long utime = stol(values[13]);
-    long stime = stol(values[14]);
-    long cutime = stol(values[15]);
-    long cstime = stol(values[16]);
-    long starttime = stol(values[21]);
-    long total_time = utime + stime + cutime + cstime;
+    ProcStat stat;
+    if (!ProcessStat(pid, stat)) return 0.0;
+    return ProcessCpuUsage(stat);
+}
+
+float Parser::ProcessCpuUsage(const ProcStat& stat) {
+    long total_time = stat.utime + stat.stime + stat.cutime + stat.cstime;
     long uptime;
     std::ifstream uptime_file("/proc/uptime");
     uptime_file >> uptime;
     long hertz = sysconf(_SC_CLK_TCK);
-    float seconds = uptime - (starttime / hertz);
+    float seconds = uptime - (stat.starttime / hertz);
     return 100.0 * ((total_time / hertz) / seconds);
 }
 
 float Parser::ProcessMemoryUsage(int pid) {
-    std::ifstream file("/proc/" + std::to_string(pid) + "/status");
-    std::string line;
-    float memory = 0;
-    while (std::getline(file, line)) {
-        if (line.find("VmRSS:") == 0) {
-            std::istringstream iss(line);
-            std::string key;
-            iss >> key >> memory;
-            break;
-        }
-    }
-    return memory / 1024; 
+    // VmRSS is about 20 lines in, well within the first 4 KB
+    char path[64], buf[4096];
+    ProcPath(path, sizeof(path), pid, "status");
+    if (Parser::ReadFile(path, buf, sizeof(buf)) == 0) return 0;
+    long long rss_kb = KeyValue(buf, "VmRSS:");
+    return rss_kb > 0 ? rss_kb / 1024.0f : 0.0f;
 }
 
 std::string Parser::Command(int pid) {
-    std::ifstream file("/proc/" + std::to_string(pid) + "/cmdline");
+    char path[64], chunk[4096];
+    ProcPath(path, sizeof(path), pid, "cmdline");
     std::string cmd;
-    std::getline(file, cmd);
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd >= 0) {
+        ssize_t n;
+        while ((n = read(fd, chunk, sizeof(chunk))) > 0) cmd.append(chunk, n);
+        close(fd);
+    }
+    // Stops at the first newline, as the line-based read this replaces did
+    size_t nl = cmd.find('\n');
+    if (nl != std::string::npos) cmd.resize(nl);
     return cmd.empty() ? "[unknown]" : cmd;
-}
\ No newline at end of file
+}
+
+long Parser::OpenFileLimit(int pid) {
+    std::ifstream file("/proc/" + std::to_string(pid) + "/limits");
+    std::string line;
+    while (std::getline(file, line)) {
+        // "Max open files            1024                 524288               files"
+        if (line.find("Max open files") != 0) continue;
+        std::istringstream ss(line.substr(14));
+        std::string soft;
+        ss >> soft;
+        if (soft.empty() || soft == "unlimited") return -1;
+        return std::stol(soft);
+    }
+    return -1;
+}
+
+std::vector<int> Parser::CpuList(const std::string& list) {
+    std::vector<int> cpus;
+    std::istringstream ss(list);
+    std::string range;
+    while (std::getline(ss, range, ',')) {
+        if (range.empty() || range == "\n") continue;
+        char* end;
+        long lo = strtol(range.c_str(), &end, 10);
+        long hi = lo;
+        if (end == range.c_str() || lo < 0) return {};
+        if (*end == '-') {
+            const char* start = end + 1;
+            hi = strtol(start, &end, 10);
+            if (end == start || hi < lo) return {};
+        }
+        if (*end != '\0' && *end != '\n') return {};
+        for (long c = lo; c <= hi; ++c) cpus.push_back((int)c);
+    }
+    return cpus;
+}